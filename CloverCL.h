@@ -26,8 +26,24 @@
 
 #define __CL_ENABLE_EXCEPTIONS
 
+#ifdef CLOVER_NATIVE
+#include "native_cl.h"
+#else
 #include <CL/cl.hpp>
+#endif
 #include <string>
+#include <map>
+
+/*
+ * Storage type of the mesh fields on the device, it must match field_t in
+ * ocl_knls.h. A CLOVER_MIXED_PRECISION build stores the fields as float;
+ * the work arrays, reductions and everything handed to Fortran stay double.
+ */
+#ifdef CLOVER_MIXED_PRECISION
+typedef cl_float field_t;
+#else
+typedef cl_double field_t;
+#endif
 
 /** 
  * @class CloverCL
@@ -43,87 +59,89 @@ class CloverCL {
         //static int const fixed_wg_min_size_large_dim   = WG_SIZE_X; // x value passed in by preprocessor 
         //static int const fixed_wg_min_size_small_dim   = WG_SIZE_Y; // y value passed in by preprocessor 
 
-        static int const local_wg_x_idealgas = WG_SIZE_X_IDEALGAS;
-        static int const local_wg_y_idealgas = WG_SIZE_Y_IDEALGAS;
+        // Defaults come from the WG_SIZE_* macros in the Makefile; the point-wise
+        // kernel sizes below may be replaced at start up by autotuneWorkGroupSizes
+        static int local_wg_x_idealgas;
+        static int local_wg_y_idealgas;
 
-        static int const local_wg_x_accelerate = WG_SIZE_X_ACCELERATE;
-        static int const local_wg_y_accelerate = WG_SIZE_Y_ACCELERATE;
+        static int local_wg_x_accelerate;
+        static int local_wg_y_accelerate;
 
-        static int const local_wg_x_viscosity = WG_SIZE_X_VISCOSITY;
-        static int const local_wg_y_viscosity = WG_SIZE_Y_VISCOSITY;
+        static int local_wg_x_viscosity;
+        static int local_wg_y_viscosity;
 
-        static int const local_wg_x_fluxcalc = WG_SIZE_X_FLUXCALC;
-        static int const local_wg_y_fluxcalc = WG_SIZE_Y_FLUXCALC;
+        static int local_wg_x_fluxcalc;
+        static int local_wg_y_fluxcalc;
 
-        static int const local_wg_x_reset = WG_SIZE_X_RESET;
-        static int const local_wg_y_reset = WG_SIZE_Y_RESET;
+        static int local_wg_x_reset;
+        static int local_wg_y_reset;
 
-        static int const local_wg_x_revert = WG_SIZE_X_REVERT;
-        static int const local_wg_y_revert = WG_SIZE_Y_REVERT;
+        static int local_wg_x_revert;
+        static int local_wg_y_revert;
 
-        static int const local_wg_x_pdv = WG_SIZE_X_PDV;
-        static int const local_wg_y_pdv = WG_SIZE_Y_PDV;
+        static int local_wg_x_pdv;
+        static int local_wg_y_pdv;
 
-        static int const local_wg_x_adveccell_xdir_sec1s1 = WG_SIZE_X_ADVECCELL_XDIR_SEC1S1;
-        static int const local_wg_y_adveccell_xdir_sec1s1 = WG_SIZE_Y_ADVECCELL_XDIR_SEC1S1;
+        static int local_wg_x_adveccell_xdir_sec1s1;
+        static int local_wg_y_adveccell_xdir_sec1s1;
 
-        static int const local_wg_x_adveccell_xdir_sec1s2 = WG_SIZE_X_ADVECCELL_XDIR_SEC1S2;
-        static int const local_wg_y_adveccell_xdir_sec1s2 = WG_SIZE_Y_ADVECCELL_XDIR_SEC1S2;
+        static int local_wg_x_adveccell_xdir_sec1s2;
+        static int local_wg_y_adveccell_xdir_sec1s2;
 
-        static int const local_wg_x_adveccell_xdir_sec2 = WG_SIZE_X_ADVECCELL_XDIR_SEC2;
-        static int const local_wg_y_adveccell_xdir_sec2 = WG_SIZE_Y_ADVECCELL_XDIR_SEC2;
+        static int local_wg_x_adveccell_xdir_sec2;
+        static int local_wg_y_adveccell_xdir_sec2;
 
-        static int const local_wg_x_adveccell_xdir_sec3 = WG_SIZE_X_ADVECCELL_XDIR_SEC3;
-        static int const local_wg_y_adveccell_xdir_sec3 = WG_SIZE_Y_ADVECCELL_XDIR_SEC3;
+        static int local_wg_x_adveccell_xdir_sec3;
+        static int local_wg_y_adveccell_xdir_sec3;
 
-        static int const local_wg_x_adveccell_ydir_sec1s1 = WG_SIZE_X_ADVECCELL_YDIR_SEC1S1;
-        static int const local_wg_y_adveccell_ydir_sec1s1 = WG_SIZE_Y_ADVECCELL_YDIR_SEC1S1;
+        static int local_wg_x_adveccell_ydir_sec1s1;
+        static int local_wg_y_adveccell_ydir_sec1s1;
 
-        static int const local_wg_x_adveccell_ydir_sec1s2 = WG_SIZE_X_ADVECCELL_YDIR_SEC1S2;
-        static int const local_wg_y_adveccell_ydir_sec1s2 = WG_SIZE_Y_ADVECCELL_YDIR_SEC1S2;
+        static int local_wg_x_adveccell_ydir_sec1s2;
+        static int local_wg_y_adveccell_ydir_sec1s2;
 
-        static int const local_wg_x_adveccell_ydir_sec2 = WG_SIZE_X_ADVECCELL_YDIR_SEC2;
-        static int const local_wg_y_adveccell_ydir_sec2 = WG_SIZE_Y_ADVECCELL_YDIR_SEC2;
+        static int local_wg_x_adveccell_ydir_sec2;
+        static int local_wg_y_adveccell_ydir_sec2;
 
-        static int const local_wg_x_adveccell_ydir_sec3 = WG_SIZE_X_ADVECCELL_YDIR_SEC3;
-        static int const local_wg_y_adveccell_ydir_sec3 = WG_SIZE_Y_ADVECCELL_YDIR_SEC3;
+        static int local_wg_x_adveccell_ydir_sec3;
+        static int local_wg_y_adveccell_ydir_sec3;
 
 
-        static int const local_wg_x_advecmom_vol = WG_SIZE_X_ADVECMOM_VOL;
-        static int const local_wg_y_advecmom_vol = WG_SIZE_Y_ADVECMOM_VOL;
+        static int local_wg_x_advecmom_vol;
+        static int local_wg_y_advecmom_vol;
 
-        static int const local_wg_x_advecmom_node_x = WG_SIZE_X_ADVECMOM_NODE_X;
-        static int const local_wg_y_advecmom_node_x = WG_SIZE_Y_ADVECMOM_NODE_X;
+        static int local_wg_x_advecmom_node_x;
+        static int local_wg_y_advecmom_node_x;
 
-        static int const local_wg_x_advecmom_node_mass_pre_x = WG_SIZE_X_ADVECMOM_NODE_MASS_PRE_X;
-        static int const local_wg_y_advecmom_node_mass_pre_x = WG_SIZE_Y_ADVECMOM_NODE_MASS_PRE_X;
+        static int local_wg_x_advecmom_node_mass_pre_x;
+        static int local_wg_y_advecmom_node_mass_pre_x;
 
-        static int const local_wg_x_advecmom_flux_vec1_x = WG_SIZE_X_ADVECMOM_FLUX_VEC1_X;
-        static int const local_wg_y_advecmom_flux_vec1_x = WG_SIZE_Y_ADVECMOM_FLUX_VEC1_X;
+        static int local_wg_x_advecmom_flux_vec1_x;
+        static int local_wg_y_advecmom_flux_vec1_x;
 
-        static int const local_wg_x_advecmom_flux_notvec1_x = WG_SIZE_X_ADVECMOM_FLUX_NOTVEC1_X;
-        static int const local_wg_y_advecmom_flux_notvec1_x = WG_SIZE_Y_ADVECMOM_FLUX_NOTVEC1_X;
+        static int local_wg_x_advecmom_flux_notvec1_x;
+        static int local_wg_y_advecmom_flux_notvec1_x;
 
-        static int const local_wg_x_advecmom_vel_x = WG_SIZE_X_ADVECMOM_VEL_X;
-        static int const local_wg_y_advecmom_vel_x = WG_SIZE_Y_ADVECMOM_VEL_X;
+        static int local_wg_x_advecmom_vel_x;
+        static int local_wg_y_advecmom_vel_x;
 
 
-        static int const local_wg_x_advecmom_node_y = WG_SIZE_X_ADVECMOM_NODE_Y;
-        static int const local_wg_y_advecmom_node_y = WG_SIZE_Y_ADVECMOM_NODE_Y;
+        static int local_wg_x_advecmom_node_y;
+        static int local_wg_y_advecmom_node_y;
 
-        static int const local_wg_x_advecmom_node_mass_pre_y = WG_SIZE_X_ADVECMOM_NODE_MASS_PRE_Y;
-        static int const local_wg_y_advecmom_node_mass_pre_y = WG_SIZE_Y_ADVECMOM_NODE_MASS_PRE_Y;
+        static int local_wg_x_advecmom_node_mass_pre_y;
+        static int local_wg_y_advecmom_node_mass_pre_y;
 
-        static int const local_wg_x_advecmom_flux_vec1_y = WG_SIZE_X_ADVECMOM_FLUX_VEC1_Y;
-        static int const local_wg_y_advecmom_flux_vec1_y = WG_SIZE_Y_ADVECMOM_FLUX_VEC1_Y;
+        static int local_wg_x_advecmom_flux_vec1_y;
+        static int local_wg_y_advecmom_flux_vec1_y;
 
-        static int const local_wg_x_advecmom_flux_notvec1_y = WG_SIZE_X_ADVECMOM_FLUX_NOTVEC1_Y;
-        static int const local_wg_y_advecmom_flux_notvec1_y = WG_SIZE_Y_ADVECMOM_FLUX_NOTVEC1_Y;
+        static int local_wg_x_advecmom_flux_notvec1_y;
+        static int local_wg_y_advecmom_flux_notvec1_y;
 
-        static int const local_wg_x_advecmom_vel_y = WG_SIZE_X_ADVECMOM_VEL_Y;
-        static int const local_wg_y_advecmom_vel_y = WG_SIZE_Y_ADVECMOM_VEL_Y;
+        static int local_wg_x_advecmom_vel_y;
+        static int local_wg_y_advecmom_vel_y;
 
-        static int const local_wg_largedim_updatehalo = WG_SIZE_LARGEDIM_UPDATEHALO;
+        static int local_wg_largedim_updatehalo;
         static int const local_wg_smalldim_updatehalo = WG_SIZE_SMALLDIM_UPDATEHALO;
 
         static int const local_wg_largedim_comms = WG_SIZE_LARGEDIM_COMMS;
@@ -132,6 +150,12 @@ class CloverCL {
         static int const local_wg_x_calcdt_fieldsumm = WG_SIZE_X_CALCDT_FIELDSUMM;
         static int const local_wg_y_calcdt_fieldsumm = WG_SIZE_Y_CALCDT_FIELDSUMM;
 
+        static int const local_wg_x_adveccell_fused = WG_SIZE_X_ADVECCELL_FUSED;
+        static int const local_wg_y_adveccell_fused = WG_SIZE_Y_ADVECCELL_FUSED;
+
+        static int const local_wg_x_advecmom_fused = WG_SIZE_X_ADVECMOM_FUSED;
+        static int const local_wg_y_advecmom_fused = WG_SIZE_Y_ADVECMOM_FUSED;
+
         static int const local_wg_x_reduction = WG_SIZE_X_REDUCTION;
 
         static int const cpu_reduction_first_level_wgs= CPU_REDUCTION_NUM_FIRST_LEVEL_WGS;
@@ -205,8 +229,114 @@ class CloverCL {
         static cl_device_type device_type;
 
         static int number_of_red_levels;
+        static int number_of_calcdt_groups;
+
+        // single launch reductions, one counter and partials slot per reduced quantity,
+        // only the dt minimum as the field summary reduces in its own kernel
+        static bool single_launch_reduction;
+        static bool subgroup_reduction;
+        static int single_red_num_groups;
+        static int const single_red_num_slots = 1;
         static cl::Event last_event;
 
+        // update every selected field's halo with one launch per pair of faces
+        static bool batched_halo;
+
+        // exchange every field in one message per face through pinned staging
+        // buffers, indexed by face-1, with MPI traffic overlapping the copies
+        static bool pipelined_exchange;
+        static field_t* exchange_send_host[4];
+        static field_t* exchange_recv_host[4];
+
+        // host transfers go through a persistently mapped pinned pool; on CPU
+        // devices the field buffers are host allocated and mapped instead, so
+        // each transfer is a single host copy. The pool holds device data, so
+        // it is where field_t is widened
+        static bool pinned_staging;
+        static bool mapped_fields;
+        static int const staging_slots = 8;
+        static field_t* staging_host[staging_slots];
+        static std::vector<cl::Event> staging_events;
+
+        // the mesh buffers are sub-buffers of a few arenas, placed by the
+        // phases of a step they are live in so that scratch from phases that
+        // never meet shares memory. Buffers whose handles are swapped hold
+        // live data in any of them, so they count as live in every phase
+        static int const PHASE_TIMESTEP   = 1;
+        static int const PHASE_FLUX       = 2;
+        static int const PHASE_ADVEC_CELL = 4;
+        static int const PHASE_ADVEC_MOM  = 8;
+        static int const PHASE_ALL        = 15;
+
+        struct PlannedBuffer {
+            cl::Buffer* buffer;
+            size_t bytes;
+            cl_mem_flags flags;
+            int phases;
+            int arena;
+            size_t offset;
+        };
+
+        static std::vector<PlannedBuffer> planned_buffers;
+        static std::vector<cl::Buffer> arena_buffers;
+        static std::vector<size_t> arena_bytes;
+
+        // reset_field swaps the time level handles instead of copying, and
+        // revert is skipped as the PdV corrector rewrites what it restores
+        static bool buffer_swap;
+
+        // each advec_cell sweep is one tiled kernel writing into the spare
+        // density and energy buffers, which are then swapped with density1
+        // and energy1
+        static bool fused_advec_cell;
+
+        // each advec_mom sweep advects both velocities in one tiled kernel,
+        // writing into spare buffers that are swapped with xvel1 and yvel1
+        static bool fused_advec_mom;
+
+        // kernels and staged transfers keep their events, read back once a
+        // step into a Chrome trace and a per kernel summary
+        static bool event_profiling;
+        static int profile_step;
+        static cl::Event profile_event;
+
+        // the launches of a hydro step are recorded once per advect_x parity
+        // and replayed from then on, as a cl_khr_command_buffer or else as a
+        // list of kernels cloned with their arguments. dt stays on the device
+        static bool step_replay;
+        static int recording_parity;
+        static double dt_value_host;
+
+        // dt, j, k, control, x and y of the limiting cell, read back into a
+        // persistently mapped pinned buffer so the host only waits on the event
+        static int const dt_result_size = 6;
+        static double* dt_result_host;
+        static cl::Event dt_result_event;
+
+        // the point-wise kernels also come guard-free from a second program
+        // built with INTERIOR_TILES, keyed by the kernel they stand in for.
+        // They run over the whole work-groups inside the range and the
+        // guarded kernel over the strips left at the top and right
+        static bool interior_tiles;
+        static cl::Program interior_program;
+        static std::map<cl_kernel, cl::Kernel> interior_kernels;
+
+        // faces of the chunk on the edge of the mesh as HALO_FACE_ bits, built
+        // into the programs so an interior chunk has no boundary code at all
+        static int external_faces;
+
+        // an ensemble of independent meshes stacked in y as one tall chunk,
+        // each member_ymax rows with its own halos. dt is one per member and
+        // the dt result and field summary are reduced per member
+        static int ensemble_members;
+        static int member_ymax;
+
+        // volume, mass, internal energy, kinetic energy and pressure from the
+        // single launch field summary, read back the same way as the dt result
+        static int const field_summary_values = 5;
+        static double* field_summary_host;
+        static cl::Event field_summary_event;
+
         static int mpi_rank; 
         static int xmax_c;
         static int ymax_c;
@@ -215,12 +345,34 @@ class CloverCL {
                          int x_min, int x_max, int y_min, int y_max,
                          int num_states, double g_small, double g_big,
                          double dtmin, double dtc_safe, double dtu_safe,
-                         double dtv_safe, double dtdiv_safe);
+                         double dtv_safe, double dtdiv_safe, bool autotune,
+                         bool single_reduction, bool batched_halo_update,
+                         bool pipelined_halo_exchange, bool pinned_host_staging,
+                         bool buffer_swap_fields, bool fused_advec, bool fused_mom,
+                         bool event_profile, bool replay_steps,
+                         bool interior_tile_kernels, int chunk_external_faces,
+                         int number_of_members, bool native_kernels);
+
+        static void resize(int x_min, int x_max, int y_min, int y_max,
+                           int num_states, double g_small, double g_big,
+                           double dtmin, double dtc_safe, double dtu_safe,
+                           double dtv_safe, double dtdiv_safe, int chunk_external_faces);
 
         static void determineWorkGroupSizeInfo();
         static void calculateKernelLaunchParams(int x_max, int y_max);
 
+        static std::string deviceIdentity();
+
+        static void autotuneWorkGroupSizes(int x_max, int y_max);
+        static void writeTuningCache(std::string const& block);
+        static std::string tuningCacheKey(int x_max, int y_max);
+        static double timeKernelLaunch(cl::Kernel kernel, int num_x, int num_y, int wg_x, int wg_y);
+        static void tuneKernelWorkGroup(std::string name, cl::Kernel kernel, int num_x, int num_y,
+                                        int* wg_x, int* wg_y, bool fixed_y);
+
         static void allocateReductionInterBuffers();
+        static void buildSingleReductionObjects();
+        static void enqueueSingleReduction(cl::CommandQueue& queue, cl::Kernel& kernel);
 
         static void allocateLocalMemoryObjects();
 
@@ -239,9 +391,39 @@ class CloverCL {
         static void initCommandQueue();
 
         static void loadProgram(int xmin, int xmax, int ymin, int ymax);
+        static void initMesh(int x_min, int x_max, int y_min, int y_max,
+                             int num_states, double g_small, double g_big,
+                             double dtmin, double dtc_safe, double dtu_safe,
+                             double dtv_safe, double dtdiv_safe);
+        static void releaseMeshBuffers();
+        static cl::Program buildProgram(std::string const& source, std::string const& options,
+                                        std::vector<cl::Device> devices);
+        static void buildInteriorKernels(std::string const& source, std::string const& options,
+                                         std::vector<cl::Device> devices);
+        static void setKernelArg(cl::Kernel& kernel, cl_uint index, cl::Buffer const& buffer);
 
         static void createBuffers( int x_max, int y_max, int num_states);
 
+        static void planBuffer(cl::Buffer* buffer, size_t bytes, cl_mem_flags flags, int phases);
+        static size_t plannedOffset(int arena, PlannedBuffer const& planned, size_t align);
+        static void allocatePlannedBuffers();
+        static void reportDeviceMemory();
+
+        static void createExchangeBuffers(int x_max, int y_max);
+
+        static void createStagingPool(int x_max, int y_max);
+        static void stagedReadBuffers(int count, cl::Buffer** buffers, size_t* elements, double** host);
+        static void stagedWriteBuffers(int count, cl::Buffer** buffers, size_t* elements, double** host);
+        static void stagedReadBufferRect(cl::Buffer& field, cl::size_t<3>& b_origin, cl::size_t<3>& region,
+                                         size_t b_row_pitch, double* host, std::vector<cl::Event>* wait_events);
+        static void stagedWriteBufferRect(cl::Buffer& field, cl::size_t<3>& b_origin, cl::size_t<3>& region,
+                                          size_t b_row_pitch, double* host);
+        static void enqueueCommsRead(cl::Buffer& buffer, size_t bytes, double* host, int slot);
+        static void commsReadToHost(size_t bytes, double* host, int slot);
+        static void enqueueCommsWrite(cl::Buffer& buffer, size_t bytes, double* host, int slot);
+        static void fieldToHost(double* host, const field_t* field, size_t elements);
+        static void hostToField(field_t* field, const double* host, size_t elements);
+
         static void checkErr( cl_int err, std::string name);
 
         static void reportError( cl::Error err, std::string message);
@@ -288,6 +470,10 @@ class CloverCL {
 
         static void enqueueKernel_nooffsets_localwg(cl::Kernel kernel, int num_x, int num_y, int wg_x, int wg_y);
         static void enqueueKernel_nooffsets_recordevent_localwg(cl::Kernel kernel, int num_x, int num_y, int wg_x, int wg_y);
+        static void enqueueKernel_offsets_recordevent_localwg(cl::Kernel kernel, int x_off, int y_off,
+                                                              int num_x, int num_y, int wg_x, int wg_y);
+        static void enqueueKernel_interior_localwg(cl::Kernel kernel, int num_x, int num_y,
+                                                   int interior_x, int interior_y, int wg_x, int wg_y);
 
         static void enqueueKernel( cl::Kernel kernel, int x_min, int x_max, int y_min, int y_max);
 
@@ -296,6 +482,10 @@ class CloverCL {
         static void initialiseKernelArgs(int x_min, int x_max, int y_min, int y_max,
                                          double g_small, double g_big, double dtmin,
                                          double dtc_safe, double dtu_safe, double dtv_safe, double dtdiv_safe);
+        static void bindFieldKernelArgs();
+        static void swapFieldBuffers();
+        static void swapAdvectedFields();
+        static void swapAdvectedVelocities();
 
         static std::string errToString(cl_int err);
 
@@ -314,14 +504,40 @@ class CloverCL {
                                          double* celldx, double* celldy, double* volume ); 
 
         static void dumpBinary();
+        static std::string programCacheName(std::string const& source, std::string const& options);
+        static bool loadProgramBinary(cl::Program& target, std::string binary_name,
+                                      std::vector<cl::Device> devices, std::string options);
+        static void saveProgramBinary(cl::Program& target, std::string binary_name);
 
         static void print_profile_stats();
         static void zero_profiling_timers();
 
+        static cl::Event* profiledEvent();
+        static void recordKernelEvent(cl::Kernel const& kernel, cl::Event const& event, size_t work_items);
+        static void recordTransferEvent(const char* name, cl::Event const& event, size_t bytes);
+        static void countKernelGlobalArgs(std::string const& source);
+        static void drainProfiledEvents(bool wait);
+        static void finishEventProfile();
+
+        static void initStepReplay();
+        static void writeStepDt(double dt);
+
+        static void enqueueEnsembleReduction(cl::Kernel& kernel);
+        static void recordStepLaunch(cl::Kernel const& kernel, cl::NDRange const& offset,
+                                     cl::NDRange const& global, cl::NDRange const& local);
+        static void beginStepRecording(int parity, double dtold, double dtrise, double dtmax);
+        static void splitStepRecording();
+        static void endStepRecording(int parity);
+        static bool replayStep(int parity, double dtmin);
+
         static cl::Buffer density0_buffer;
         static cl::Buffer density1_buffer;
         static cl::Buffer energy0_buffer;
         static cl::Buffer energy1_buffer;
+        static cl::Buffer density1_advec_buffer;
+        static cl::Buffer energy1_advec_buffer;
+        static cl::Buffer xvel1_advec_buffer;
+        static cl::Buffer yvel1_advec_buffer;
         static cl::Buffer pressure_buffer;
         static cl::Buffer soundspeed_buffer;
         static cl::Buffer celldx_buffer;
@@ -347,11 +563,17 @@ class CloverCL {
         static cl::Buffer yarea_buffer;
 
         static cl::Buffer dt_min_val_buffer;
-        static cl::Buffer vol_sum_val_buffer;
-        static cl::Buffer mass_sum_val_buffer;
-        static cl::Buffer ie_sum_val_buffer;
-        static cl::Buffer ke_sum_val_buffer;
-        static cl::Buffer press_sum_val_buffer;
+        static cl::Buffer dt_result_buffer;
+        static cl::Buffer dt_result_pinned_buffer;
+        static cl::Buffer dt_value_buffer;
+        static cl::Buffer single_red_partials_buffer;
+        static cl::Buffer single_red_counter_buffer;
+        static cl::Buffer field_summary_partials_buffer;
+        static cl::Buffer field_summary_counter_buffer;
+        static cl::Buffer field_summary_result_buffer;
+        static cl::Buffer field_summary_pinned_buffer;
+        static cl::Buffer ensemble_dt_partials_buffer;
+        static cl::Buffer ensemble_dt_counter_buffer;
 
         static cl::Buffer state_density_buffer;
         static cl::Buffer state_energy_buffer;
@@ -373,12 +595,14 @@ class CloverCL {
         static cl::Buffer right_send_buffer;
         static cl::Buffer right_recv_buffer;
 
+        static cl::Buffer exchange_send_buffers[4];
+        static cl::Buffer exchange_recv_buffers[4];
+        static cl::Buffer exchange_send_pinned_buffers[4];
+        static cl::Buffer exchange_recv_pinned_buffers[4];
+
+        static cl::Buffer staging_pinned_buffers[staging_slots];
+
         static cl::Buffer cpu_min_red_buffer;
-        static cl::Buffer cpu_vol_red_buffer;
-        static cl::Buffer cpu_mass_red_buffer;
-        static cl::Buffer cpu_ie_red_buffer;
-        static cl::Buffer cpu_ke_red_buffer;
-        static cl::Buffer cpu_press_red_buffer;
 
         static cl::Buffer work_array1_buffer;
         static cl::Buffer work_array2_buffer;
@@ -402,6 +626,8 @@ class CloverCL {
         static cl::Kernel advec_cell_ydir_sec1_s2_knl;
         static cl::Kernel advec_cell_ydir_sec2_knl;
         static cl::Kernel advec_cell_ydir_sec3_knl;
+        static cl::Kernel advec_cell_xdir_fused_knl;
+        static cl::Kernel advec_cell_ydir_fused_knl;
 
         static cl::Kernel advec_mom_vol_knl;
         static cl::Kernel advec_mom_node_mass_pre_x_knl;
@@ -414,22 +640,18 @@ class CloverCL {
         static cl::Kernel advec_mom_flux_y_vec1_knl;
         static cl::Kernel advec_mom_flux_y_vecnot1_knl;
         static cl::Kernel advec_mom_vel_y_knl;
+        static cl::Kernel advec_mom_xdir_fused_knl;
+        static cl::Kernel advec_mom_ydir_fused_knl;
 
         static cl::Kernel dt_calc_knl;
+        static cl::Kernel dt_locate_knl;
+        static cl::Kernel dt_finalise_knl;
+        static cl::Kernel dt_ensemble_knl;
+        static cl::Kernel timestep_fused_knl;
 
         static cl::Kernel minimum_red_knl;
-        static cl::Kernel vol_sum_red_knl;
-        static cl::Kernel mass_sum_red_knl;
-        static cl::Kernel ie_sum_red_knl;
-        static cl::Kernel ke_sum_red_knl;
-        static cl::Kernel press_sum_red_knl;
 
         static cl::Kernel minimum_red_last_knl;
-        static cl::Kernel vol_sum_red_last_knl;
-        static cl::Kernel mass_sum_red_last_knl;
-        static cl::Kernel ie_sum_red_last_knl;
-        static cl::Kernel ke_sum_red_last_knl;
-        static cl::Kernel press_sum_red_last_knl;
 
         static cl::Kernel pdv_correct_knl;
         static cl::Kernel pdv_predict_knl;
@@ -460,6 +682,8 @@ class CloverCL {
         static cl::Kernel update_halo_right_flux_y_knl;
         static cl::Kernel update_halo_top_flux_y_knl;
         static cl::Kernel update_halo_bottom_flux_y_knl;
+        static cl::Kernel update_halo_bottom_top_batched_knl;
+        static cl::Kernel update_halo_left_right_batched_knl;
 
         static cl::Kernel read_top_buffer_knl;
         static cl::Kernel read_right_buffer_knl;
@@ -470,20 +694,16 @@ class CloverCL {
         static cl::Kernel write_right_buffer_knl;
         static cl::Kernel write_bottom_buffer_knl;
         static cl::Kernel write_left_buffer_knl;
+        static cl::Kernel pack_left_right_all_knl;
+        static cl::Kernel pack_top_bottom_all_knl;
+        static cl::Kernel unpack_left_right_all_knl;
+        static cl::Kernel unpack_top_bottom_all_knl;
 
         static cl::Kernel minimum_red_cpu_knl;
-        static cl::Kernel vol_sum_red_cpu_knl; 
-        static cl::Kernel mass_sum_red_cpu_knl; 
-        static cl::Kernel ie_sum_red_cpu_knl; 
-        static cl::Kernel ke_sum_red_cpu_knl; 
-        static cl::Kernel press_sum_red_cpu_knl; 
 
         static std::vector<cl::Kernel> min_reduction_kernels;
-        static std::vector<cl::Kernel> vol_sum_reduction_kernels;
-        static std::vector<cl::Kernel> mass_sum_reduction_kernels;
-        static std::vector<cl::Kernel> ie_sum_reduction_kernels;
-        static std::vector<cl::Kernel> ke_sum_reduction_kernels;
-        static std::vector<cl::Kernel> press_sum_reduction_kernels;
+
+        static cl::Kernel min_single_reduction_knl;
 
         static std::vector<int> num_workitems_tolaunch;
         static std::vector<int> num_workitems_per_wg;
@@ -494,18 +714,8 @@ class CloverCL {
         static std::vector<int> num_elements_per_wi;
 
         static std::vector<cl::Buffer> min_interBuffers;
-        static std::vector<cl::Buffer> vol_interBuffers;
-        static std::vector<cl::Buffer> mass_interBuffers;
-        static std::vector<cl::Buffer> ie_interBuffers;
-        static std::vector<cl::Buffer> ke_interBuffers;
-        static std::vector<cl::Buffer> press_interBuffers;
 
         static std::vector<cl::LocalSpaceArg> min_local_memory_objects;
-        static std::vector<cl::LocalSpaceArg> vol_local_memory_objects;
-        static std::vector<cl::LocalSpaceArg> mass_local_memory_objects;
-        static std::vector<cl::LocalSpaceArg> ie_local_memory_objects;
-        static std::vector<cl::LocalSpaceArg> ke_local_memory_objects;
-        static std::vector<cl::LocalSpaceArg> press_local_memory_objects;
 
         static long accelerate_time;
         static long advec_cell_time;
@@ -25,32 +25,33 @@
 #include "ocl_knls.h"
 
 __kernel void accelerate_ocl_kernel(
-    const double dt,
-    __global const double * restrict xarea,
-    __global const double * restrict yarea,
-    __global const double * restrict volume,
-    __global const double * restrict density0,
-    __global const double * restrict pressure,
-    __global const double * restrict viscosity,
-    __global const double * restrict xvel0,
-    __global const double * restrict yvel0,
-    __global double * restrict xvel1,
-    __global double * restrict yvel1)
+    __global const double * restrict dt_value,
+    __global const field_t * restrict xarea,
+    __global const field_t * restrict yarea,
+    __global const field_t * restrict volume,
+    __global const field_t * restrict density0,
+    __global const field_t * restrict pressure,
+    __global const field_t * restrict viscosity,
+    __global const field_t * restrict xvel0,
+    __global const field_t * restrict yvel0,
+    __global field_t * restrict xvel1,
+    __global field_t * restrict yvel1)
 {
-    double nodal_mass, stepbymass;
+    const calc_t dt = MEMBER_DT(dt_value, get_global_id(1));
+    calc_t nodal_mass, stepbymass;
 
     int k = get_global_id(1);
     int j = get_global_id(0);
 
-    if ( (j>=2) && (j<=XMAXPLUSTWO) && (k>=2) && (k<=YMAXPLUSTWO) ) {
+    if ( IN_RANGE( (j>=2) && (j<=XMAXPLUSTWO) && (k>=2) && (k<=YMAXPLUSTWO) ) ) {
 
         nodal_mass=(density0[ARRAYXY(j-1,k-1,XMAXPLUSFOUR)]*volume[ARRAYXY(j-1,k-1,XMAXPLUSFOUR)]
                    +density0[ARRAYXY(j  ,k-1,XMAXPLUSFOUR)]*volume[ARRAYXY(j  ,k-1,XMAXPLUSFOUR)]
                    +density0[ARRAYXY(j  ,k  ,XMAXPLUSFOUR)]*volume[ARRAYXY(j  ,k  ,XMAXPLUSFOUR)]
                    +density0[ARRAYXY(j-1,k  ,XMAXPLUSFOUR)]*volume[ARRAYXY(j-1,k  ,XMAXPLUSFOUR)])
-                   *0.25;
+                   *CALC(0.25);
 
-        stepbymass=0.5*dt/nodal_mass;
+        stepbymass=CALC(0.5)*dt/nodal_mass;
 
         xvel1[ARRAYXY(j,k,XMAXPLUSFIVE)]=xvel0[ARRAYXY(j,k,XMAXPLUSFIVE)] 
                                          -stepbymass
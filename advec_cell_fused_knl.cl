@@ -0,0 +1,359 @@
+/*Crown Copyright 2012 AWE.
+*
+* This file is part of CloverLeaf.
+*
+* CloverLeaf is free software: you can redistribute it and/or modify it under
+* the terms of the GNU General Public License as published by the
+* Free Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* CloverLeaf is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* CloverLeaf. If not, see http://www.gnu.org/licenses/. */
+
+/**
+ *  @brief OCL device-side fused advection cell kernels
+ *  @author Andrew Mallinson, David Beckingsale, Wayne Gaudin
+ *  @details Performs one directional sweep of the cell advection in a single
+ *  launch. Each work group builds the pre-advection volumes and the density
+ *  and energy of its tile, plus the two cell stencil halo in the sweep
+ *  direction, in local memory, computes the face fluxes there and then
+ *  updates its cells. Only the mass flux, which the momentum advection
+ *  needs, and the advected density and energy are written to global memory.
+ *  The results go to separate output fields, as neighbouring work groups
+ *  still read the old values for their halos, and every cell of the output
+ *  is written so the host can swap the output in for density1 and energy1.
+ */
+
+#include "ocl_knls.h"
+
+#define XDIR_CELL_TILE_X (ADVEC_WG_X+4)
+#define XDIR_VOL_TILE_X (ADVEC_WG_X+2)
+#define XDIR_FACE_TILE_X (ADVEC_WG_X+1)
+
+/*
+ * Van Leer limited mass and energy flux through one face, as in the
+ * section2 kernels. vertexd_ratio is the width of the face's cell over the
+ * width of the cell the limiter differences across.
+ */
+void advec_cell_face_flux(
+    const double vol_flux,
+    const double pre_vol_donor,
+    const double vertexd_ratio,
+    const double density_upwind,
+    const double density_donor,
+    const double density_downwind,
+    const double energy_upwind,
+    const double energy_donor,
+    const double energy_downwind,
+    double *mass_flux,
+    double *ener_flux)
+{
+    double sigmat, sigmav, sigmam, sigma3, sigma4;
+    double diffuw, diffdw, limiter;
+    const double one_by_six=1.0/6.0;
+
+    sigmat = fabs(vol_flux) / pre_vol_donor;
+    sigma3 = (1.0 + sigmat)*vertexd_ratio;
+    sigma4 = 2.0 - sigmat;
+
+    sigmav = sigmat;
+
+    diffuw = density_donor - density_upwind;
+    diffdw = density_downwind - density_donor;
+
+    if (diffuw*diffdw > 0.0) {
+        limiter = (1.0 - sigmav) * copysign(1.0,diffdw) * fmin(fabs(diffuw), fmin( fabs(diffdw), one_by_six*(sigma3 * fabs(diffuw) + sigma4 * fabs(diffdw) ) ) );
+    } else {
+        limiter = 0.0;
+    }
+    *mass_flux = vol_flux * ( density_donor + limiter );
+
+    sigmam = fabs( *mass_flux ) / ( density_donor * pre_vol_donor );
+    diffuw = energy_donor - energy_upwind;
+    diffdw = energy_downwind - energy_donor;
+
+    if (diffuw*diffdw > 0.0) {
+        limiter = (1.0 - sigmam) * copysign(1.0,diffdw) * fmin(fabs(diffuw), fmin( fabs(diffdw), one_by_six * (sigma3 * fabs(diffuw) + sigma4 * fabs(diffdw) ) ) );
+    } else {
+        limiter = 0.0;
+    }
+
+    *ener_flux = *mass_flux * ( energy_donor + limiter );
+}
+
+__kernel __attribute__((reqd_work_group_size(ADVEC_WG_X, ADVEC_WG_Y, 1)))
+void advec_cell_xdir_fused_kernel(
+    const int sweep_number,
+    __global const field_t * restrict vertexdx,
+    __global const field_t * restrict volume,
+    __global const field_t * restrict vol_flux_x,
+    __global const field_t * restrict vol_flux_y,
+    __global const field_t * restrict density1,
+    __global const field_t * restrict energy1,
+    __global field_t * restrict mass_flux_x,
+    __global field_t * restrict density1_out,
+    __global field_t * restrict energy1_out)
+{
+    int upwind, donor, downwind, dif;
+    double mass_flux, ener_flux;
+
+    __local double density_tile[XDIR_CELL_TILE_X*ADVEC_WG_Y];
+    __local double energy_tile[XDIR_CELL_TILE_X*ADVEC_WG_Y];
+    __local double pre_vol_tile[XDIR_VOL_TILE_X*ADVEC_WG_Y];
+    __local double mass_flux_tile[XDIR_FACE_TILE_X*ADVEC_WG_Y];
+    __local double ener_flux_tile[XDIR_FACE_TILE_X*ADVEC_WG_Y];
+
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    int lj = get_local_id(0);
+    int lk = get_local_id(1);
+
+    // tile column c holds cell j_origin+c-2, pre_vol column c cell j_origin+c-1
+    // and face column c face j_origin+c
+    int j_origin = get_group_id(0)*ADVEC_WG_X;
+
+    __local double *density_row = density_tile + lk*XDIR_CELL_TILE_X;
+    __local double *energy_row = energy_tile + lk*XDIR_CELL_TILE_X;
+    __local double *pre_vol_row = pre_vol_tile + lk*XDIR_VOL_TILE_X;
+    __local double *mass_flux_row = mass_flux_tile + lk*XDIR_FACE_TILE_X;
+    __local double *ener_flux_row = ener_flux_tile + lk*XDIR_FACE_TILE_X;
+
+    for (int index = lj; index < XDIR_CELL_TILE_X; index += ADVEC_WG_X) {
+        int jt = j_origin + index - 2;
+
+        if ( (jt>=0) && (jt<=XMAXPLUSTHREE) && (k<=YMAXPLUSTHREE) ) {
+            density_row[index] = density1[ARRAYXY(jt,k,XMAXPLUSFOUR)];
+            energy_row[index] = energy1[ARRAYXY(jt,k,XMAXPLUSFOUR)];
+        } else {
+            density_row[index] = 0.0;
+            energy_row[index] = 0.0;
+        }
+    }
+
+    // section1, the volume before this sweep
+    for (int index = lj; index < XDIR_VOL_TILE_X; index += ADVEC_WG_X) {
+        int jt = j_origin + index - 1;
+
+        if ( (jt>=0) && (jt<=XMAXPLUSTHREE) && (k<=YMAXPLUSTHREE) ) {
+            if (sweep_number == 1) {
+                pre_vol_row[index] = volume[ARRAYXY(jt,k,XMAXPLUSFOUR)]
+                                     + (vol_flux_x[ARRAYXY(jt+1,k,XMAXPLUSFIVE)] - vol_flux_x[ARRAYXY(jt,k,XMAXPLUSFIVE)]
+                                        + vol_flux_y[ARRAYXY(jt,k+1,XMAXPLUSFOUR)] - vol_flux_y[ARRAYXY(jt,k,XMAXPLUSFOUR)]);
+            } else {
+                pre_vol_row[index] = volume[ARRAYXY(jt,k,XMAXPLUSFOUR)] + vol_flux_x[ARRAYXY(jt+1,k,XMAXPLUSFIVE)] - vol_flux_x[ARRAYXY(jt,k,XMAXPLUSFIVE)];
+            }
+        } else {
+            pre_vol_row[index] = 0.0;
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // section2, the fluxes through every face of the tile's cells
+    for (int index = lj; index < XDIR_FACE_TILE_X; index += ADVEC_WG_X) {
+        int jf = j_origin + index;
+
+        if ( (jf>=2) && (jf<=XMAXPLUSTHREE) && (k>=2) && (k<=YMAXPLUSONE) ) {
+
+            if ( vol_flux_x[ARRAYXY(jf,k,XMAXPLUSFIVE)] > 0.0 ) {
+                upwind   = jf-2;
+                donor    = jf-1;
+                downwind = jf;
+                dif      = donor;
+            } else {
+                upwind   = min(jf+1,XMAXPLUSTWO);
+                donor    = jf;
+                downwind = jf-1;
+                dif      = upwind;
+            }
+
+            advec_cell_face_flux(vol_flux_x[ARRAYXY(jf,k,XMAXPLUSFIVE)],
+                                 pre_vol_row[donor-j_origin+1],
+                                 vertexdx[jf] / vertexdx[dif],
+                                 density_row[upwind-j_origin+2], density_row[donor-j_origin+2], density_row[downwind-j_origin+2],
+                                 energy_row[upwind-j_origin+2], energy_row[donor-j_origin+2], energy_row[downwind-j_origin+2],
+                                 &mass_flux, &ener_flux);
+
+            mass_flux_row[index] = mass_flux;
+            ener_flux_row[index] = ener_flux;
+
+            // the last face is the first face of the next work group
+            if (index < ADVEC_WG_X) {
+                mass_flux_x[ARRAYXY(jf,k,XMAXPLUSFIVE)] = mass_flux;
+            }
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // section3, the advected cell values
+    if ( (j<=XMAXPLUSTHREE) && (k<=YMAXPLUSTHREE) ) {
+        double density = density_row[lj+2];
+        double energy = energy_row[lj+2];
+
+        if ( (j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE) ) {
+            double pre_vol = pre_vol_row[lj+1];
+            double pre_mass, post_mass, post_ener, advec_vol;
+
+            pre_mass = density * pre_vol;
+
+            post_mass = pre_mass + mass_flux_row[lj] - mass_flux_row[lj+1];
+
+            post_ener = ( energy * pre_mass + ener_flux_row[lj] - ener_flux_row[lj+1] ) / post_mass;
+
+            advec_vol = pre_vol + vol_flux_x[ARRAYXY(j  , k, XMAXPLUSFIVE)] -
+                                  vol_flux_x[ARRAYXY(j+1, k, XMAXPLUSFIVE)];
+
+            density = post_mass / advec_vol;
+            energy = post_ener;
+        }
+
+        density1_out[ARRAYXY(j,k,XMAXPLUSFOUR)] = density;
+        energy1_out[ARRAYXY(j,k,XMAXPLUSFOUR)] = energy;
+    }
+}
+
+#define YDIR_CELL_TILE_Y (ADVEC_WG_Y+4)
+#define YDIR_VOL_TILE_Y (ADVEC_WG_Y+2)
+#define YDIR_FACE_TILE_Y (ADVEC_WG_Y+1)
+
+__kernel __attribute__((reqd_work_group_size(ADVEC_WG_X, ADVEC_WG_Y, 1)))
+void advec_cell_ydir_fused_kernel(
+    const int sweep_number,
+    __global const field_t * restrict vertexdy,
+    __global const field_t * restrict volume,
+    __global const field_t * restrict vol_flux_x,
+    __global const field_t * restrict vol_flux_y,
+    __global const field_t * restrict density1,
+    __global const field_t * restrict energy1,
+    __global field_t * restrict mass_flux_y,
+    __global field_t * restrict density1_out,
+    __global field_t * restrict energy1_out)
+{
+    int upwind, donor, downwind, dif;
+    double mass_flux, ener_flux;
+
+    __local double density_tile[ADVEC_WG_X*YDIR_CELL_TILE_Y];
+    __local double energy_tile[ADVEC_WG_X*YDIR_CELL_TILE_Y];
+    __local double pre_vol_tile[ADVEC_WG_X*YDIR_VOL_TILE_Y];
+    __local double mass_flux_tile[ADVEC_WG_X*YDIR_FACE_TILE_Y];
+    __local double ener_flux_tile[ADVEC_WG_X*YDIR_FACE_TILE_Y];
+
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    int lj = get_local_id(0);
+    int lk = get_local_id(1);
+
+    // tile row r holds cell k_origin+r-2, pre_vol row r cell k_origin+r-1
+    // and face row r face k_origin+r
+    int k_origin = get_group_id(1)*ADVEC_WG_Y;
+
+    for (int index = lk; index < YDIR_CELL_TILE_Y; index += ADVEC_WG_Y) {
+        int kt = k_origin + index - 2;
+
+        if ( (kt>=0) && (kt<=YMAXPLUSTHREE) && (j<=XMAXPLUSTHREE) ) {
+            density_tile[index*ADVEC_WG_X+lj] = density1[ARRAYXY(j,kt,XMAXPLUSFOUR)];
+            energy_tile[index*ADVEC_WG_X+lj] = energy1[ARRAYXY(j,kt,XMAXPLUSFOUR)];
+        } else {
+            density_tile[index*ADVEC_WG_X+lj] = 0.0;
+            energy_tile[index*ADVEC_WG_X+lj] = 0.0;
+        }
+    }
+
+    // section1, the volume before this sweep
+    for (int index = lk; index < YDIR_VOL_TILE_Y; index += ADVEC_WG_Y) {
+        int kt = k_origin + index - 1;
+
+        if ( (kt>=0) && (kt<=YMAXPLUSTHREE) && (j<=XMAXPLUSTHREE) ) {
+            if (sweep_number == 1) {
+                pre_vol_tile[index*ADVEC_WG_X+lj] = volume[ARRAYXY(j,kt,XMAXPLUSFOUR)]
+                                                    + (  vol_flux_y[ARRAYXY(j  ,kt+1,XMAXPLUSFOUR)]
+                                                       - vol_flux_y[ARRAYXY(j  ,kt  ,XMAXPLUSFOUR)]
+                                                       + vol_flux_x[ARRAYXY(j+1,kt  ,XMAXPLUSFIVE)]
+                                                       - vol_flux_x[ARRAYXY(j  ,kt  ,XMAXPLUSFIVE)]
+                                                      );
+            } else {
+                pre_vol_tile[index*ADVEC_WG_X+lj] = volume[ARRAYXY(j,kt,XMAXPLUSFOUR)]
+                                                    + vol_flux_y[ARRAYXY(j,kt+1,XMAXPLUSFOUR)] - vol_flux_y[ARRAYXY(j,kt,XMAXPLUSFOUR)];
+            }
+        } else {
+            pre_vol_tile[index*ADVEC_WG_X+lj] = 0.0;
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // section2, the fluxes through every face of the tile's cells
+    for (int index = lk; index < YDIR_FACE_TILE_Y; index += ADVEC_WG_Y) {
+        int kf = k_origin + index;
+
+        if ( (j>=2) && (j<=XMAXPLUSONE) && (kf>=2) && (kf<=YMAXPLUSTHREE) ) {
+
+            if ( vol_flux_y[ARRAYXY(j,kf,XMAXPLUSFOUR)] > 0.0 ) {
+                upwind   = kf-2;
+                donor    = kf-1;
+                downwind = kf;
+                dif      = donor;
+            } else {
+                upwind   = min(kf+1,YMAXPLUSTWO);
+                donor    = kf;
+                downwind = kf-1;
+                dif      = upwind;
+            }
+
+            advec_cell_face_flux(vol_flux_y[ARRAYXY(j,kf,XMAXPLUSFOUR)],
+                                 pre_vol_tile[(donor-k_origin+1)*ADVEC_WG_X+lj],
+                                 vertexdy[kf] / vertexdy[dif],
+                                 density_tile[(upwind-k_origin+2)*ADVEC_WG_X+lj],
+                                 density_tile[(donor-k_origin+2)*ADVEC_WG_X+lj],
+                                 density_tile[(downwind-k_origin+2)*ADVEC_WG_X+lj],
+                                 energy_tile[(upwind-k_origin+2)*ADVEC_WG_X+lj],
+                                 energy_tile[(donor-k_origin+2)*ADVEC_WG_X+lj],
+                                 energy_tile[(downwind-k_origin+2)*ADVEC_WG_X+lj],
+                                 &mass_flux, &ener_flux);
+
+            mass_flux_tile[index*ADVEC_WG_X+lj] = mass_flux;
+            ener_flux_tile[index*ADVEC_WG_X+lj] = ener_flux;
+
+            // the last face is the first face of the next work group
+            if (index < ADVEC_WG_Y) {
+                mass_flux_y[ARRAYXY(j,kf,XMAXPLUSFOUR)] = mass_flux;
+            }
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // section3, the advected cell values
+    if ( (j<=XMAXPLUSTHREE) && (k<=YMAXPLUSTHREE) ) {
+        double density = density_tile[(lk+2)*ADVEC_WG_X+lj];
+        double energy = energy_tile[(lk+2)*ADVEC_WG_X+lj];
+
+        if ( (j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE) ) {
+            double pre_vol = pre_vol_tile[(lk+1)*ADVEC_WG_X+lj];
+            double pre_mass, post_mass, post_ener, advec_vol;
+
+            pre_mass = density * pre_vol;
+
+            post_mass = pre_mass + mass_flux_tile[lk*ADVEC_WG_X+lj] - mass_flux_tile[(lk+1)*ADVEC_WG_X+lj];
+
+            post_ener = ( energy * pre_mass + ener_flux_tile[lk*ADVEC_WG_X+lj] - ener_flux_tile[(lk+1)*ADVEC_WG_X+lj] ) / post_mass;
+
+            advec_vol = pre_vol + vol_flux_y[ARRAYXY(j,k  , XMAXPLUSFOUR)] -
+                                  vol_flux_y[ARRAYXY(j,k+1, XMAXPLUSFOUR)];
+
+            density = post_mass / advec_vol;
+            energy = post_ener;
+        }
+
+        density1_out[ARRAYXY(j,k,XMAXPLUSFOUR)] = density;
+        energy1_out[ARRAYXY(j,k,XMAXPLUSFOUR)] = energy;
+    }
+}
@@ -25,9 +25,9 @@
 #include "ocl_knls.h"
 
 __kernel void advec_cell_xdir_section1_sweep1_kernel(
-    __global const double *restrict volume,      
-    __global const double *restrict vol_flux_x,  
-    __global const double *restrict vol_flux_y,  
+    __global const field_t *restrict volume,      
+    __global const field_t *restrict vol_flux_x,  
+    __global const field_t *restrict vol_flux_y,  
     __global double *restrict pre_vol,     
     __global double *restrict post_vol)
 {
@@ -47,8 +47,8 @@ __kernel void advec_cell_xdir_section1_sweep1_kernel(
 
 
 __kernel void advec_cell_xdir_section1_sweep2_kernel(
-    __global const double * restrict volume,      
-    __global const double * restrict vol_flux_x,  
+    __global const field_t * restrict volume,      
+    __global const field_t * restrict vol_flux_x,  
     __global double * restrict pre_vol,     
     __global double * restrict post_vol)
 {
@@ -66,11 +66,11 @@ __kernel void advec_cell_xdir_section1_sweep2_kernel(
 
 
 __kernel void advec_cell_xdir_section2_kernel(
-    __global const double * restrict vertexdx,    
-    __global const double * restrict density1,    
-    __global const double * restrict energy1,     
-    __global double * restrict mass_flux_x, 
-    __global const double * restrict vol_flux_x,  
+    __global const field_t * restrict vertexdx,    
+    __global const field_t * restrict density1,    
+    __global const field_t * restrict energy1,     
+    __global field_t * restrict mass_flux_x, 
+    __global const field_t * restrict vol_flux_x,  
     __global const double * restrict pre_vol,     
     __global double * restrict ener_flux)
 {
@@ -132,10 +132,10 @@ __kernel void advec_cell_xdir_section2_kernel(
 }
 
 __kernel void advec_cell_xdir_section3_kernel(
-    __global double * restrict density1,    
-    __global double * restrict energy1,     
-    __global const double * restrict mass_flux_x, 
-    __global const double * restrict vol_flux_x,  
+    __global field_t * restrict density1,    
+    __global field_t * restrict energy1,     
+    __global const field_t * restrict mass_flux_x, 
+    __global const field_t * restrict vol_flux_x,  
     __global const double * restrict pre_vol,     
     __global double * restrict pre_mass,    
     __global double * restrict post_mass,   
@@ -176,9 +176,9 @@ __kernel void advec_cell_xdir_section3_kernel(
 
 
 __kernel void advec_cell_ydir_section1_sweep1_kernel(
-    __global const double * restrict volume,      
-    __global const double * restrict vol_flux_x,  
-    __global const double * restrict vol_flux_y,  
+    __global const field_t * restrict volume,      
+    __global const field_t * restrict vol_flux_x,  
+    __global const field_t * restrict vol_flux_y,  
     __global double * restrict pre_vol,     
     __global double * restrict post_vol)
 {
@@ -201,8 +201,8 @@ __kernel void advec_cell_ydir_section1_sweep1_kernel(
 }
 
 __kernel void advec_cell_ydir_section1_sweep2_kernel(
-    __global const double * restrict volume,      
-    __global const double * restrict vol_flux_y,  
+    __global const field_t * restrict volume,      
+    __global const field_t * restrict vol_flux_y,  
     __global double * restrict pre_vol,     
     __global double * restrict post_vol)
 {
@@ -221,11 +221,11 @@ __kernel void advec_cell_ydir_section1_sweep2_kernel(
 
 
 __kernel void advec_cell_ydir_section2_kernel(
-    __global const double * restrict vertexdy,    
-    __global const double * restrict density1,    
-    __global const double * restrict energy1,     
-    __global double * restrict mass_flux_y, 
-    __global const double * restrict vol_flux_y,  
+    __global const field_t * restrict vertexdy,    
+    __global const field_t * restrict density1,    
+    __global const field_t * restrict energy1,     
+    __global field_t * restrict mass_flux_y, 
+    __global const field_t * restrict vol_flux_y,  
     __global const double * restrict pre_vol,     
     __global double * restrict ener_flux)
 {
@@ -290,10 +290,10 @@ __kernel void advec_cell_ydir_section2_kernel(
 }
 
 __kernel void advec_cell_ydir_section3_kernel(
-    __global double * restrict density1,    
-    __global double * restrict energy1,     
-    __global const double * restrict mass_flux_y, 
-    __global const double * restrict vol_flux_y,  
+    __global field_t * restrict density1,    
+    __global field_t * restrict energy1,     
+    __global const field_t * restrict mass_flux_y, 
+    __global const field_t * restrict vol_flux_y,  
     __global const double * restrict pre_vol,     
     __global double * restrict pre_mass,    
     __global double * restrict post_mass,   
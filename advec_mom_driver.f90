@@ -17,7 +17,8 @@
 
 !>  @brief Momentum advection driver
 !>  @author Wayne Gaudin
-!>  @details Invokes the user specified momentum advection kernel.
+!>  @details Invokes the user specified momentum advection kernel, or the
+!>  fused kernel that advects both velocities in one pass.
 
 MODULE advec_mom_driver_module
 
@@ -52,4 +53,32 @@ SUBROUTINE advec_mom_driver(chunk,which_vel,direction,sweep_number)
 
 END SUBROUTINE advec_mom_driver
 
+SUBROUTINE advec_mom_fused_driver(chunk,direction,sweep_number)
+
+  USE clover_module
+
+  IMPLICIT NONE
+
+  INTEGER :: chunk,direction,sweep_number,vector
+
+  IF(chunks(chunk)%task.EQ.parallel%task) THEN
+
+    IF (use_vector_loops) THEN
+        vector=1
+    ELSE
+        vector=0
+    ENDIF
+
+    CALL advec_mom_fused_kernel_ocl(chunks(chunk)%field%x_min,    &
+                                    chunks(chunk)%field%x_max,    &
+                                    chunks(chunk)%field%y_min,    &
+                                    chunks(chunk)%field%y_max,    &
+                                    sweep_number,                 &
+                                    direction,                    &
+                                    vector                        )
+
+  ENDIF
+
+END SUBROUTINE advec_mom_fused_driver
+
 END MODULE advec_mom_driver_module
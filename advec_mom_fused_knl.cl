@@ -0,0 +1,400 @@
+/*Crown Copyright 2012 AWE.
+*
+* This file is part of CloverLeaf.
+*
+* CloverLeaf is free software: you can redistribute it and/or modify it under
+* the terms of the GNU General Public License as published by the
+* Free Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* CloverLeaf is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* CloverLeaf. If not, see http://www.gnu.org/licenses/. */
+
+/**
+ *  @brief OCL device-side fused advection momentum kernels
+ *  @author Andrew Mallinson, David Beckingsale, Wayne Gaudin
+ *  @details Performs one directional sweep of the momentum advection for
+ *  both velocity components in a single launch. Each work group computes
+ *  the node flux and the post and pre advection node masses of its tile,
+ *  plus the stencil halo in the sweep direction, in local memory once, and
+ *  uses them to advect xvel1 and yvel1 together. Neighbouring work groups
+ *  still read the old velocities for their halos, so the results go to
+ *  separate output fields, with every vertex written so the host can swap
+ *  the outputs in for xvel1 and yvel1.
+ */
+
+#include "ocl_knls.h"
+
+#define XDIR_VEL_TILE_X (ADVMOM_WG_X+4)
+#define XDIR_NODE_FLUX_TILE_X (ADVMOM_WG_X+3)
+#define XDIR_NODE_MASS_TILE_X (ADVMOM_WG_X+2)
+#define XDIR_MOM_FLUX_TILE_X (ADVMOM_WG_X+1)
+
+/*
+ * The cell volume after this sweep, as advec_mom_vol_ocl_kernel computes it.
+ */
+double advec_mom_post_vol(
+    const int mom_sweep,
+    __global const field_t * restrict volume,
+    __global const field_t * restrict vol_flux_x,
+    __global const field_t * restrict vol_flux_y,
+    const int j,
+    const int k)
+{
+    if (mom_sweep==1) {
+        return volume[ARRAYXY(j,k,XMAXPLUSFOUR)]
+               +vol_flux_y[ARRAYXY(j,k+1,XMAXPLUSFOUR)]
+               -vol_flux_y[ARRAYXY(j,k  ,XMAXPLUSFOUR)];
+    } else if (mom_sweep==2) {
+        return volume[ARRAYXY(j  ,k  ,XMAXPLUSFOUR)]
+               +vol_flux_x[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)]
+               -vol_flux_x[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)];
+    } else {
+        return volume[ARRAYXY(j  ,k  ,XMAXPLUSFOUR)];
+    }
+}
+
+/*
+ * Momentum flux through the node face between vertex i and i+1 in the sweep
+ * direction, as in the flux_vec1 and flux_notvec1 kernels. pre_m0 and
+ * pre_p1 are the pre-advection node masses at i and i+1, vel_m1 to vel_p2
+ * the velocity from i-1 to i+2 and width_m1 to width_p1 the cell widths
+ * from i-1 to i+1.
+ */
+double advec_mom_face_flux(
+    const int vector,
+    const double node_flux,
+    const double pre_m0,
+    const double pre_p1,
+    const double vel_m1,
+    const double vel_m0,
+    const double vel_p1,
+    const double vel_p2,
+    const double width_m1,
+    const double width,
+    const double width_p1)
+{
+    double sigma, sigma2, wind, wind2, advec_vel;
+    double vdiffuw, vdiffdw, vdiffuw2, vdiffdw2, auw, adw, auw2, limiter, limiter2;
+
+    if (vector == 1) {
+        sigma=fabs(node_flux)/(pre_p1);
+        sigma2=fabs(node_flux)/(pre_m0);
+        vdiffuw=vel_p1-vel_p2;
+        vdiffdw=vel_m0-vel_p1;
+        vdiffuw2=vel_m0-vel_m1;
+        vdiffdw2=-1*vdiffdw;
+        auw=fabs(vdiffuw);
+        adw=fabs(vdiffdw);
+        auw2=fabs(vdiffuw2);
+        wind=1.0;
+        wind2=1.0;
+
+        if(vdiffdw<=0.0) wind=-1.0;
+        if(vdiffdw2<=0.0) wind2=-1.0;
+        limiter=wind*fmin(width*((2.0-sigma)*adw/width+(1.0+sigma)*auw/width_p1)/6.0,fmin(auw,adw));
+        limiter2=wind2*fmin(width*((2.0-sigma2)*adw/width+(1.0+sigma2)*auw2/width_m1)/6.0,fmin(auw2,adw));
+        if(vdiffuw*vdiffdw<=0.0) limiter=0.0;
+        if(vdiffuw2*vdiffdw2<=0.0) limiter2=0.0;
+        if(node_flux<0.0){
+            advec_vel=vel_p1+(1.0-sigma)*limiter;
+        }
+        else{
+            advec_vel=vel_m0+(1.0-sigma2)*limiter2;
+        }
+    } else {
+        double donor_vel, dif_width;
+
+        if(node_flux<0.0){
+            sigma=fabs(node_flux)/(pre_p1);
+            donor_vel=vel_p1;
+            vdiffuw=vel_p1-vel_p2;
+            vdiffdw=vel_m0-vel_p1;
+            dif_width=width_p1;
+        }
+        else{
+            sigma=fabs(node_flux)/(pre_m0);
+            donor_vel=vel_m0;
+            vdiffuw=vel_m0-vel_m1;
+            vdiffdw=vel_p1-vel_m0;
+            dif_width=width_m1;
+        }
+        limiter=0.0;
+        if(vdiffuw*vdiffdw>0.0){
+            auw=fabs(vdiffuw);
+            adw=fabs(vdiffdw);
+            wind=1.0;
+            if(vdiffdw<=0.0) wind=-1.0;
+            limiter=wind*fmin(width*((2.0-sigma)*adw/width+(1.0+sigma)*auw/dif_width)/6.0,fmin(auw,adw));
+        }
+        advec_vel=donor_vel+(1.0-sigma)*limiter;
+    }
+
+    return advec_vel*node_flux;
+}
+
+__kernel __attribute__((reqd_work_group_size(ADVMOM_WG_X, ADVMOM_WG_Y, 1)))
+void advec_mom_xdir_fused_kernel(
+    const int mom_sweep,
+    const int vector,
+    __global const field_t * restrict celldx,
+    __global const field_t * restrict volume,
+    __global const field_t * restrict vol_flux_x,
+    __global const field_t * restrict vol_flux_y,
+    __global const field_t * restrict mass_flux_x,
+    __global const field_t * restrict density1,
+    __global const field_t * restrict xvel1,
+    __global const field_t * restrict yvel1,
+    __global field_t * restrict xvel1_out,
+    __global field_t * restrict yvel1_out)
+{
+    __local double node_flux_tile[XDIR_NODE_FLUX_TILE_X*ADVMOM_WG_Y];
+    __local double node_mass_post_tile[XDIR_NODE_MASS_TILE_X*ADVMOM_WG_Y];
+    __local double node_mass_pre_tile[XDIR_NODE_MASS_TILE_X*ADVMOM_WG_Y];
+    __local double xvel_tile[XDIR_VEL_TILE_X*ADVMOM_WG_Y];
+    __local double yvel_tile[XDIR_VEL_TILE_X*ADVMOM_WG_Y];
+    __local double xmom_flux_tile[XDIR_MOM_FLUX_TILE_X*ADVMOM_WG_Y];
+    __local double ymom_flux_tile[XDIR_MOM_FLUX_TILE_X*ADVMOM_WG_Y];
+
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    int lj = get_local_id(0);
+    int lk = get_local_id(1);
+
+    // velocity column c holds vertex j_origin+c-2, node flux column c vertex
+    // j_origin+c-2, node mass column c vertex j_origin+c-1 and momentum flux
+    // column c vertex j_origin+c-1
+    int j_origin = get_group_id(0)*ADVMOM_WG_X;
+
+    __local double *node_flux_row = node_flux_tile + lk*XDIR_NODE_FLUX_TILE_X;
+    __local double *node_mass_post_row = node_mass_post_tile + lk*XDIR_NODE_MASS_TILE_X;
+    __local double *node_mass_pre_row = node_mass_pre_tile + lk*XDIR_NODE_MASS_TILE_X;
+    __local double *xvel_row = xvel_tile + lk*XDIR_VEL_TILE_X;
+    __local double *yvel_row = yvel_tile + lk*XDIR_VEL_TILE_X;
+    __local double *xmom_flux_row = xmom_flux_tile + lk*XDIR_MOM_FLUX_TILE_X;
+    __local double *ymom_flux_row = ymom_flux_tile + lk*XDIR_MOM_FLUX_TILE_X;
+
+    for (int index = lj; index < XDIR_VEL_TILE_X; index += ADVMOM_WG_X) {
+        int jt = j_origin + index - 2;
+
+        if ( (jt>=0) && (jt<=XMAXPLUSFOUR) && (k<=YMAXPLUSFOUR) ) {
+            xvel_row[index] = xvel1[ARRAYXY(jt,k,XMAXPLUSFIVE)];
+            yvel_row[index] = yvel1[ARRAYXY(jt,k,XMAXPLUSFIVE)];
+        } else {
+            xvel_row[index] = 0.0;
+            yvel_row[index] = 0.0;
+        }
+    }
+
+    for (int index = lj; index < XDIR_NODE_FLUX_TILE_X; index += ADVMOM_WG_X) {
+        int jt = j_origin + index - 2;
+
+        if ( (jt>=0) && (jt<=XMAXPLUSTHREE) && (k>=2) && (k<=YMAXPLUSTWO) ) {
+            node_flux_row[index] = 0.25*(mass_flux_x[ARRAYXY(jt  ,k-1,XMAXPLUSFIVE)]
+                                        +mass_flux_x[ARRAYXY(jt  ,k  ,XMAXPLUSFIVE)]
+                                        +mass_flux_x[ARRAYXY(jt+1,k-1,XMAXPLUSFIVE)]
+                                        +mass_flux_x[ARRAYXY(jt+1,k  ,XMAXPLUSFIVE)]);
+        } else {
+            node_flux_row[index] = 0.0;
+        }
+    }
+
+    for (int index = lj; index < XDIR_NODE_MASS_TILE_X; index += ADVMOM_WG_X) {
+        int jt = j_origin + index - 1;
+
+        if ( (jt>=1) && (jt<=XMAXPLUSTHREE) && (k>=2) && (k<=YMAXPLUSTWO) ) {
+            node_mass_post_row[index] = 0.25*( density1[ARRAYXY(jt  ,k-1,XMAXPLUSFOUR)]
+                                              *advec_mom_post_vol(mom_sweep, volume, vol_flux_x, vol_flux_y, jt  , k-1)
+                                              +density1[ARRAYXY(jt  ,k  ,XMAXPLUSFOUR)]
+                                              *advec_mom_post_vol(mom_sweep, volume, vol_flux_x, vol_flux_y, jt  , k  )
+                                              +density1[ARRAYXY(jt-1,k-1,XMAXPLUSFOUR)]
+                                              *advec_mom_post_vol(mom_sweep, volume, vol_flux_x, vol_flux_y, jt-1, k-1)
+                                              +density1[ARRAYXY(jt-1,k  ,XMAXPLUSFOUR)]
+                                              *advec_mom_post_vol(mom_sweep, volume, vol_flux_x, vol_flux_y, jt-1, k  ));
+        } else {
+            node_mass_post_row[index] = 1.0;
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // node mass column c and node flux column c+1 are the same vertex
+    for (int index = lj; index < XDIR_NODE_MASS_TILE_X; index += ADVMOM_WG_X) {
+        node_mass_pre_row[index] = node_mass_post_row[index]
+                                   -node_flux_row[index]
+                                   +node_flux_row[index+1];
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (int index = lj; index < XDIR_MOM_FLUX_TILE_X; index += ADVMOM_WG_X) {
+        int jf = j_origin + index - 1;
+
+        if ( (jf>=1) && (jf<=XMAXPLUSTWO) && (k>=2) && (k<=YMAXPLUSTWO) ) {
+            double node_flux = node_flux_row[index+1];
+
+            xmom_flux_row[index] = advec_mom_face_flux(vector, node_flux,
+                                                       node_mass_pre_row[index], node_mass_pre_row[index+1],
+                                                       xvel_row[index], xvel_row[index+1], xvel_row[index+2], xvel_row[index+3],
+                                                       celldx[jf-1], celldx[jf], celldx[jf+1]);
+
+            ymom_flux_row[index] = advec_mom_face_flux(vector, node_flux,
+                                                       node_mass_pre_row[index], node_mass_pre_row[index+1],
+                                                       yvel_row[index], yvel_row[index+1], yvel_row[index+2], yvel_row[index+3],
+                                                       celldx[jf-1], celldx[jf], celldx[jf+1]);
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if ( (j<=XMAXPLUSFOUR) && (k<=YMAXPLUSFOUR) ) {
+        double xvel = xvel_row[lj+2];
+        double yvel = yvel_row[lj+2];
+
+        if ( (j>=2) && (j<=XMAXPLUSTWO) && (k>=2) && (k<=YMAXPLUSTWO) ) {
+            xvel = (xvel*node_mass_pre_row[lj+1]+xmom_flux_row[lj]-xmom_flux_row[lj+1])/node_mass_post_row[lj+1];
+            yvel = (yvel*node_mass_pre_row[lj+1]+ymom_flux_row[lj]-ymom_flux_row[lj+1])/node_mass_post_row[lj+1];
+        }
+
+        xvel1_out[ARRAYXY(j,k,XMAXPLUSFIVE)] = xvel;
+        yvel1_out[ARRAYXY(j,k,XMAXPLUSFIVE)] = yvel;
+    }
+}
+
+#define YDIR_VEL_TILE_Y (ADVMOM_WG_Y+4)
+#define YDIR_NODE_FLUX_TILE_Y (ADVMOM_WG_Y+3)
+#define YDIR_NODE_MASS_TILE_Y (ADVMOM_WG_Y+2)
+#define YDIR_MOM_FLUX_TILE_Y (ADVMOM_WG_Y+1)
+
+#define YTILE(row) ((row)*ADVMOM_WG_X+lj)
+
+__kernel __attribute__((reqd_work_group_size(ADVMOM_WG_X, ADVMOM_WG_Y, 1)))
+void advec_mom_ydir_fused_kernel(
+    const int mom_sweep,
+    const int vector,
+    __global const field_t * restrict celldy,
+    __global const field_t * restrict volume,
+    __global const field_t * restrict vol_flux_x,
+    __global const field_t * restrict vol_flux_y,
+    __global const field_t * restrict mass_flux_y,
+    __global const field_t * restrict density1,
+    __global const field_t * restrict xvel1,
+    __global const field_t * restrict yvel1,
+    __global field_t * restrict xvel1_out,
+    __global field_t * restrict yvel1_out)
+{
+    __local double node_flux_tile[ADVMOM_WG_X*YDIR_NODE_FLUX_TILE_Y];
+    __local double node_mass_post_tile[ADVMOM_WG_X*YDIR_NODE_MASS_TILE_Y];
+    __local double node_mass_pre_tile[ADVMOM_WG_X*YDIR_NODE_MASS_TILE_Y];
+    __local double xvel_tile[ADVMOM_WG_X*YDIR_VEL_TILE_Y];
+    __local double yvel_tile[ADVMOM_WG_X*YDIR_VEL_TILE_Y];
+    __local double xmom_flux_tile[ADVMOM_WG_X*YDIR_MOM_FLUX_TILE_Y];
+    __local double ymom_flux_tile[ADVMOM_WG_X*YDIR_MOM_FLUX_TILE_Y];
+
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    int lj = get_local_id(0);
+    int lk = get_local_id(1);
+
+    // velocity row r holds vertex k_origin+r-2, node flux row r vertex
+    // k_origin+r-2, node mass row r vertex k_origin+r-1 and momentum flux
+    // row r vertex k_origin+r-1
+    int k_origin = get_group_id(1)*ADVMOM_WG_Y;
+
+    for (int index = lk; index < YDIR_VEL_TILE_Y; index += ADVMOM_WG_Y) {
+        int kt = k_origin + index - 2;
+
+        if ( (kt>=0) && (kt<=YMAXPLUSFOUR) && (j<=XMAXPLUSFOUR) ) {
+            xvel_tile[YTILE(index)] = xvel1[ARRAYXY(j,kt,XMAXPLUSFIVE)];
+            yvel_tile[YTILE(index)] = yvel1[ARRAYXY(j,kt,XMAXPLUSFIVE)];
+        } else {
+            xvel_tile[YTILE(index)] = 0.0;
+            yvel_tile[YTILE(index)] = 0.0;
+        }
+    }
+
+    for (int index = lk; index < YDIR_NODE_FLUX_TILE_Y; index += ADVMOM_WG_Y) {
+        int kt = k_origin + index - 2;
+
+        if ( (j>=2) && (j<=XMAXPLUSTWO) && (kt>=0) && (kt<=YMAXPLUSTHREE) ) {
+            node_flux_tile[YTILE(index)] = 0.25*(mass_flux_y[ARRAYXY(j-1,kt  ,XMAXPLUSFOUR)]
+                                                +mass_flux_y[ARRAYXY(j  ,kt  ,XMAXPLUSFOUR)]
+                                                +mass_flux_y[ARRAYXY(j-1,kt+1,XMAXPLUSFOUR)]
+                                                +mass_flux_y[ARRAYXY(j  ,kt+1,XMAXPLUSFOUR)]);
+        } else {
+            node_flux_tile[YTILE(index)] = 0.0;
+        }
+    }
+
+    for (int index = lk; index < YDIR_NODE_MASS_TILE_Y; index += ADVMOM_WG_Y) {
+        int kt = k_origin + index - 1;
+
+        if ( (j>=2) && (j<=XMAXPLUSTWO) && (kt>=1) && (kt<=YMAXPLUSTHREE) ) {
+            node_mass_post_tile[YTILE(index)] = 0.25*(density1[ARRAYXY(j  ,kt-1,XMAXPLUSFOUR)]
+                                                      *advec_mom_post_vol(mom_sweep, volume, vol_flux_x, vol_flux_y, j  , kt-1)
+                                                      +density1[ARRAYXY(j  ,kt  ,XMAXPLUSFOUR)]
+                                                      *advec_mom_post_vol(mom_sweep, volume, vol_flux_x, vol_flux_y, j  , kt  )
+                                                      +density1[ARRAYXY(j-1,kt-1,XMAXPLUSFOUR)]
+                                                      *advec_mom_post_vol(mom_sweep, volume, vol_flux_x, vol_flux_y, j-1, kt-1)
+                                                      +density1[ARRAYXY(j-1,kt  ,XMAXPLUSFOUR)]
+                                                      *advec_mom_post_vol(mom_sweep, volume, vol_flux_x, vol_flux_y, j-1, kt  ));
+        } else {
+            node_mass_post_tile[YTILE(index)] = 1.0;
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // node mass row r and node flux row r+1 are the same vertex
+    for (int index = lk; index < YDIR_NODE_MASS_TILE_Y; index += ADVMOM_WG_Y) {
+        node_mass_pre_tile[YTILE(index)] = node_mass_post_tile[YTILE(index)]
+                                           - node_flux_tile[YTILE(index)]
+                                           + node_flux_tile[YTILE(index+1)];
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (int index = lk; index < YDIR_MOM_FLUX_TILE_Y; index += ADVMOM_WG_Y) {
+        int kf = k_origin + index - 1;
+
+        if ( (j>=2) && (j<=XMAXPLUSTWO) && (kf>=1) && (kf<=YMAXPLUSTWO) ) {
+            double node_flux = node_flux_tile[YTILE(index+1)];
+
+            xmom_flux_tile[YTILE(index)] = advec_mom_face_flux(vector, node_flux,
+                                                               node_mass_pre_tile[YTILE(index)], node_mass_pre_tile[YTILE(index+1)],
+                                                               xvel_tile[YTILE(index)], xvel_tile[YTILE(index+1)],
+                                                               xvel_tile[YTILE(index+2)], xvel_tile[YTILE(index+3)],
+                                                               celldy[kf-1], celldy[kf], celldy[kf+1]);
+
+            ymom_flux_tile[YTILE(index)] = advec_mom_face_flux(vector, node_flux,
+                                                               node_mass_pre_tile[YTILE(index)], node_mass_pre_tile[YTILE(index+1)],
+                                                               yvel_tile[YTILE(index)], yvel_tile[YTILE(index+1)],
+                                                               yvel_tile[YTILE(index+2)], yvel_tile[YTILE(index+3)],
+                                                               celldy[kf-1], celldy[kf], celldy[kf+1]);
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if ( (j<=XMAXPLUSFOUR) && (k<=YMAXPLUSFOUR) ) {
+        double xvel = xvel_tile[YTILE(lk+2)];
+        double yvel = yvel_tile[YTILE(lk+2)];
+
+        if ( (j>=2) && (j<=XMAXPLUSTWO) && (k>=2) && (k<=YMAXPLUSTWO) ) {
+            xvel = (xvel*node_mass_pre_tile[YTILE(lk+1)]+xmom_flux_tile[YTILE(lk)]-xmom_flux_tile[YTILE(lk+1)])
+                   /node_mass_post_tile[YTILE(lk+1)];
+            yvel = (yvel*node_mass_pre_tile[YTILE(lk+1)]+ymom_flux_tile[YTILE(lk)]-ymom_flux_tile[YTILE(lk+1)])
+                   /node_mass_post_tile[YTILE(lk+1)];
+        }
+
+        xvel1_out[ARRAYXY(j,k,XMAXPLUSFIVE)] = xvel;
+        yvel1_out[ARRAYXY(j,k,XMAXPLUSFIVE)] = yvel;
+    }
+}
@@ -27,9 +27,9 @@
 #include "ocl_knls.h"
 
 __kernel void advec_mom_vol_ocl_kernel(
-    __global const double * restrict volume,
-    __global const double * restrict vol_flux_x,
-    __global const double * restrict vol_flux_y,
+    __global const field_t * restrict volume,
+    __global const field_t * restrict vol_flux_x,
+    __global const field_t * restrict vol_flux_y,
     __global double * restrict pre_vol,
     __global double * restrict post_vol,
     const int mom_sweep)
@@ -72,9 +72,9 @@ __kernel void advec_mom_vol_ocl_kernel(
 }
 
 __kernel void advec_mom_node_ocl_kernel_x(
-    __global const double * restrict mass_flux_x,
+    __global const field_t * restrict mass_flux_x,
     __global double * restrict node_flux,
-    __global const double * restrict density1,
+    __global const field_t * restrict density1,
     __global const double * restrict post_vol,
     __global double * restrict node_mass_post)
 {
@@ -122,10 +122,10 @@ __kernel void advec_mom_node_mass_pre_ocl_kernel_x(
 __kernel void advec_mom_flux_ocl_kernel_x_vec1(
     __global const double * restrict node_flux,
     __global const double * restrict node_mass_pre,
-    __global const double * restrict vel1,
+    __global const field_t * restrict vel1,
     __global double * restrict advec_vel,
     __global double * restrict mom_flux,
-    __global const double * restrict celldx)
+    __global const field_t * restrict celldx)
 {
     double sigma, sigma2, wind, wind2, width;
     double vdiffuw, vdiffdw, vdiffuw2, vdiffdw2, auw, adw, auw2, limiter, limiter2;
@@ -168,10 +168,10 @@ __kernel void advec_mom_flux_ocl_kernel_x_vec1(
 __kernel void advec_mom_flux_ocl_kernel_x_notvec1(
     __global const double * restrict node_flux,
     __global const double * restrict node_mass_pre,
-    __global const double * restrict vel1,
+    __global const field_t * restrict vel1,
     __global double * restrict advec_vel,
     __global double * restrict mom_flux,
-    __global const double * restrict celldx)
+    __global const field_t * restrict celldx)
 {
     int upwind, donor, downwind, dif;
     double sigma, width, wind;
@@ -216,7 +216,7 @@ __kernel void advec_mom_vel_ocl_kernel_x(
     __global const double * restrict node_mass_post,
     __global const double * restrict node_mass_pre,
     __global const double * restrict mom_flux,
-    __global double * restrict vel1)
+    __global field_t * restrict vel1)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -240,10 +240,10 @@ __kernel void advec_mom_vel_ocl_kernel_x(
 
 
 __kernel void advec_mom_node_ocl_kernel_y(
-    __global const double * restrict mass_flux_y,
+    __global const field_t * restrict mass_flux_y,
     __global double * restrict node_flux,
     __global double * restrict node_mass_post,
-    __global const double * restrict density1,
+    __global const field_t * restrict density1,
     __global const double * restrict post_vol)
 {
 
@@ -291,10 +291,10 @@ __kernel void advec_mom_node_mass_pre_ocl_kernel_y(
 __kernel void advec_mom_flux_ocl_kernel_y_vec1(
     __global const double * restrict node_flux,
     __global const double * restrict node_mass_pre,
-    __global const double * restrict vel1,
+    __global const field_t * restrict vel1,
     __global double * restrict advec_vel,
     __global double * restrict mom_flux,
-    __global const double * restrict celldy)
+    __global const field_t * restrict celldy)
 {
     double sigma, sigma2, width, wind, wind2;
     double vdiffuw, vdiffdw, vdiffuw2, vdiffdw2, auw, adw, auw2, limiter, limiter2;
@@ -336,10 +336,10 @@ __kernel void advec_mom_flux_ocl_kernel_y_vec1(
 __kernel void advec_mom_flux_ocl_kernel_y_notvec1(
     __global const double * restrict node_flux,
     __global const double * restrict node_mass_pre,
-    __global const double * restrict vel1,
+    __global const field_t * restrict vel1,
     __global double * restrict advec_vel,
     __global double * restrict mom_flux,
-    __global const double * restrict celldy)
+    __global const field_t * restrict celldy)
 {
     int upwind, donor, downwind, dif;
     double sigma, width, wind;
@@ -384,7 +384,7 @@ __kernel void advec_mom_vel_ocl_kernel_y(
     __global const double * restrict node_mass_post,
     __global const double * restrict node_mass_pre,
     __global const double * restrict mom_flux,
-    __global double * restrict vel1)
+    __global field_t * restrict vel1)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -64,12 +64,18 @@ SUBROUTINE advection()
   fields(FIELD_MASS_FLUX_y)=1
   CALL update_halo(fields,2)
 
-  DO c=1,number_of_chunks
-    CALL advec_mom_driver(c,xvel,direction,sweep_number) 
-  ENDDO
-  DO c=1,number_of_chunks
-    CALL advec_mom_driver(c,yvel,direction,sweep_number) 
-  ENDDO
+  IF(OpenCL_fused_advec_mom) THEN
+    DO c=1,number_of_chunks
+      CALL advec_mom_fused_driver(c,direction,sweep_number)
+    ENDDO
+  ELSE
+    DO c=1,number_of_chunks
+      CALL advec_mom_driver(c,xvel,direction,sweep_number) 
+    ENDDO
+    DO c=1,number_of_chunks
+      CALL advec_mom_driver(c,yvel,direction,sweep_number) 
+    ENDDO
+  ENDIF
 
   sweep_number=2
   IF(advect_x)      direction=g_ydir
@@ -88,12 +94,18 @@ SUBROUTINE advection()
   fields(FIELD_MASS_FLUX_y)=1
   CALL update_halo(fields,2)
 
-  DO c=1,number_of_chunks
-    CALL advec_mom_driver(c,xvel,direction,sweep_number) 
-  ENDDO
-  DO c=1,number_of_chunks
-    CALL advec_mom_driver(c,yvel,direction,sweep_number) 
-  ENDDO
+  IF(OpenCL_fused_advec_mom) THEN
+    DO c=1,number_of_chunks
+      CALL advec_mom_fused_driver(c,direction,sweep_number)
+    ENDDO
+  ELSE
+    DO c=1,number_of_chunks
+      CALL advec_mom_driver(c,xvel,direction,sweep_number) 
+    ENDDO
+    DO c=1,number_of_chunks
+      CALL advec_mom_driver(c,yvel,direction,sweep_number) 
+    ENDDO
+  ENDIF
 
 END SUBROUTINE advection
 
@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+#Crown Copyright 2012 AWE.
+#
+# This file is part of CloverLeaf.
+#
+# CloverLeaf is free software: you can redistribute it and/or modify it under
+# the terms of the GNU General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your option)
+# any later version.
+#
+# CloverLeaf is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the GNU General Public License along with
+# CloverLeaf. If not, see http://www.gnu.org/licenses/.
+
+#  @brief Benchmark and regression harness over the clover_bm inputs
+#  @details Runs each chosen input in its own directory under the work directory,
+#  with opencl_event_profile and summary_baseline added to its clover.in, and
+#  collects the grind time, the per kernel device times and the full precision
+#  field summaries into one JSON file. Given a baseline JSON from an earlier run,
+#  it fails if the grind time has slowed by more than the performance tolerance
+#  or any field summary has moved by more than the summary tolerance.
+#
+#  To run on a machine without a GPU, select a CPU runtime such as pocl:-
+#
+#  ./benchmark.py --vendor pocl --type CPU --inputs clover_bm_short clover_bm2_short
+#  ./benchmark.py --vendor pocl --type CPU --baseline bm_baseline.json
+#
+#  make check runs clover_check against the stored clover_check_baseline.json
+#  with --summaries-only, as its timings come from another machine.
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+SUMMARY_FIELDS = ['volume', 'mass', 'pressure', 'internal_energy', 'kinetic_energy']
+
+def write_input(source, target, args):
+    """Copies a clover input, replacing the device selection and adding the profile options"""
+    lines = []
+    with open(source) as f:
+        for line in f:
+            key = line.strip().split('=')[0].strip().lower()
+            if key == 'opencl_vendor' and args.vendor: continue
+            if key == 'opencl_type' and args.type: continue
+            if key in ('opencl_event_profile', 'summary_baseline'): continue
+            if key == '*endclover':
+                if args.vendor: lines.append(' opencl_vendor=%s\n' % args.vendor)
+                if args.type: lines.append(' opencl_type=%s\n' % args.type)
+                lines.append(' opencl_event_profile\n')
+                lines.append(' summary_baseline=field_summary.txt\n')
+            lines.append(line)
+
+    with open(target, 'w') as f:
+        f.writelines(lines)
+
+def link_sources(run_dir, args):
+    """The kernels are built at run time from the .cl files in the working directory"""
+    src_dir = os.path.dirname(os.path.abspath(args.binary))
+    for name in os.listdir(src_dir):
+        if name.endswith('.cl') or name.endswith('.h'):
+            target = os.path.join(run_dir, name)
+            if not os.path.lexists(target):
+                os.symlink(os.path.join(src_dir, name), target)
+
+def parse_output(run_dir):
+    result = {'wall_clock': None, 'grind_time': None, 'first_step_overhead': None}
+
+    with open(os.path.join(run_dir, 'clover.out')) as f:
+        for line in f:
+            words = line.split()
+            if line.strip().startswith('Wall clock'):
+                result['wall_clock'] = float(words[-1])
+            elif line.strip().startswith('Average time per cell'):
+                result['grind_time'] = float(words[-1])
+            elif line.strip().startswith('First step overhead'):
+                result['first_step_overhead'] = float(words[-1])
+            elif words[:1] == ['x_cells']:
+                result['x_cells'] = int(words[-1])
+            elif words[:1] == ['y_cells']:
+                result['y_cells'] = int(words[-1])
+
+    # A mixed precision build reads summary_baseline rather than writing it
+    summary_file = os.path.join(run_dir, 'field_summary.txt')
+    if not os.path.exists(summary_file):
+        sys.exit('benchmark: no field summaries in %s, the harness needs a double precision build' % run_dir)
+
+    summaries = []
+    with open(summary_file) as f:
+        for line in f:
+            words = line.split()
+            if len(words) != len(SUMMARY_FIELDS) + 1: continue
+            entry = {'step': int(words[0])}
+            for name, value in zip(SUMMARY_FIELDS, words[1:]):
+                entry[name] = float(value)
+            summaries.append(entry)
+    result['field_summary'] = summaries
+    result['steps'] = summaries[-1]['step'] if summaries else 0
+
+    # The rank 0 summary written by the event profiler, one row per command
+    kernels = {}
+    profile = os.path.join(run_dir, 'clover_profile.0.txt')
+    if os.path.exists(profile):
+        with open(profile) as f:
+            for line in f:
+                words = line.split()
+                if len(words) != 8 or not re.match(r'^\d+$', words[1]): continue
+                kernels[words[0]] = {'calls': int(words[1]),
+                                     'device_s': float(words[2]),
+                                     'mean_us': float(words[4]),
+                                     'gb_per_s': float(words[6])}
+            f.seek(0)
+            for line in f:
+                m = re.match(r'Device time per step \(s\): min (\S+) mean (\S+) max (\S+)', line)
+                if m:
+                    result['device_step_s'] = {'min': float(m.group(1)), 'mean': float(m.group(2)),
+                                               'max': float(m.group(3))}
+    result['kernels'] = kernels
+
+    return result
+
+def run_input(name, args):
+    source = name if name.endswith('.in') else name + '.in'
+    source = os.path.join(os.path.dirname(os.path.abspath(args.binary)), source)
+    if not os.path.exists(source):
+        sys.exit('benchmark: no input file %s' % source)
+
+    case = os.path.basename(source)[:-3]
+    run_dir = os.path.join(args.work_dir, case)
+    if not os.path.isdir(run_dir):
+        os.makedirs(run_dir)
+    link_sources(run_dir, args)
+    write_input(source, os.path.join(run_dir, 'clover.in'), args)
+
+    for stale in ('clover.out', 'field_summary.txt', 'clover_profile.0.txt'):
+        if os.path.exists(os.path.join(run_dir, stale)):
+            os.remove(os.path.join(run_dir, stale))
+
+    command = args.launcher.split() + [os.path.abspath(args.binary)]
+    print('benchmark: running %s' % case)
+    start = time.time()
+    with open(os.path.join(run_dir, 'stdout.txt'), 'w') as log:
+        status = subprocess.call(command, cwd=run_dir, stdout=log, stderr=subprocess.STDOUT)
+    if status != 0:
+        sys.exit('benchmark: %s failed with status %d, see %s' % (case, status,
+                 os.path.join(run_dir, 'stdout.txt')))
+
+    result = parse_output(run_dir)
+    result['input'] = os.path.basename(source)
+    result['elapsed'] = time.time() - start
+    print('benchmark: %-24s grind time %.6e s, wall clock %.3f s, %d steps' %
+          (case, result['grind_time'], result['wall_clock'], result['steps']))
+    return case, result
+
+def relative(value, base):
+    if base == value: return 0.0
+    return abs(value - base)/max(abs(base), 1.0e-300)
+
+def compare(results, baseline, args):
+    """Returns the number of failures against the baseline, printing each one"""
+    failures = 0
+
+    for case, run in sorted(results['runs'].items()):
+        base = baseline.get('runs', {}).get(case)
+        if base is None:
+            print('benchmark: %-24s not in the baseline, skipped' % case)
+            continue
+
+        if not args.summaries_only:
+            slowdown = run['grind_time']/base['grind_time'] - 1.0
+            verdict = 'ok'
+            if slowdown > args.perf_tolerance:
+                verdict = 'SLOWER'
+                failures += 1
+            print('benchmark: %-24s grind time %+.1f%% against the baseline  %s' % (case, 100.0*slowdown, verdict))
+
+            # Kernel timings are noisier than the grind time, so they only warn
+            for name, kernel in sorted(run['kernels'].items()):
+                base_kernel = base.get('kernels', {}).get(name)
+                if base_kernel is None or base_kernel['device_s'] <= 0.0: continue
+                change = kernel['device_s']/base_kernel['device_s'] - 1.0
+                if change > args.kernel_tolerance:
+                    print('benchmark: %-24s   %s is %+.1f%% slower' % (case, name, 100.0*change))
+
+        base_steps = dict((entry['step'], entry) for entry in base['field_summary'])
+        worst, worst_step, worst_field = 0.0, 0, ''
+        for entry in run['field_summary']:
+            base_entry = base_steps.get(entry['step'])
+            if base_entry is None: continue
+            for field in SUMMARY_FIELDS:
+                diff = relative(entry[field], base_entry[field])
+                if diff > worst:
+                    worst, worst_step, worst_field = diff, entry['step'], field
+
+        if run['steps'] != base['steps']:
+            print('benchmark: %-24s ran %d steps, the baseline ran %d  WRONG' % (case, run['steps'], base['steps']))
+            failures += 1
+        elif worst > args.summary_tolerance:
+            print('benchmark: %-24s %s differs by %.3e at step %d  WRONG' % (case, worst_field, worst, worst_step))
+            failures += 1
+        else:
+            print('benchmark: %-24s field summaries within %.3e  ok' % (case, worst))
+
+    return failures
+
+def main():
+    parser = argparse.ArgumentParser(description='Runs clover_bm inputs and checks them against a baseline')
+    parser.add_argument('--inputs', nargs='+', default=['clover_bm_short', 'clover_bm2_short'],
+                        help='inputs to run, e.g. clover_bm4_short')
+    parser.add_argument('--binary', default='./clover_leaf')
+    parser.add_argument('--launcher', default='', help='e.g. "mpirun -np 1"')
+    parser.add_argument('--vendor', default='', help='replaces opencl_vendor in each input, e.g. pocl')
+    parser.add_argument('--type', default='', help='replaces opencl_type in each input, e.g. CPU')
+    parser.add_argument('--work-dir', default='benchmark_runs')
+    parser.add_argument('--output', default='benchmark.json')
+    parser.add_argument('--baseline', default='', help='JSON from an earlier run to check against')
+    parser.add_argument('--perf-tolerance', type=float, default=0.10,
+                        help='largest allowed fractional grind time slowdown')
+    parser.add_argument('--kernel-tolerance', type=float, default=0.25,
+                        help='fractional kernel slowdown that is reported')
+    parser.add_argument('--summary-tolerance', type=float, default=1.0e-8,
+                        help='largest allowed relative field summary difference')
+    parser.add_argument('--summaries-only', action='store_true',
+                        help='check only the steps and field summaries, for a baseline from another machine')
+    args = parser.parse_args()
+
+    if not os.path.exists(args.binary):
+        sys.exit('benchmark: no binary %s, build clover_leaf first' % args.binary)
+
+    results = {'date': time.strftime('%Y-%m-%d %H:%M:%S'),
+               'vendor': args.vendor, 'type': args.type, 'runs': {}}
+    for name in args.inputs:
+        case, result = run_input(name, args)
+        results['runs'][case] = result
+
+    with open(args.output, 'w') as f:
+        json.dump(results, f, indent=1, sort_keys=True)
+    print('benchmark: results written to %s' % args.output)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        failures = compare(results, baseline, args)
+        if failures:
+            sys.exit('benchmark: %d regression(s) against %s' % (failures, args.baseline))
+        print('benchmark: no regressions against %s' % args.baseline)
+
+if __name__ == '__main__':
+    main()
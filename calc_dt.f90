@@ -23,13 +23,45 @@ MODULE calc_dt_module
 
 CONTAINS
 
-SUBROUTINE calc_dt(chunk,local_dt,local_control,xl_pos,yl_pos,jldt,kldt)
+SUBROUTINE calc_dt_enqueue(chunk,fused)
 
   USE clover_module
 
   IMPLICIT NONE
 
   INTEGER          :: chunk
+  LOGICAL          :: fused
+
+  INTEGER          :: ocl_fused
+  INTEGER          :: ocl_async
+
+  IF(chunks(chunk)%task.NE.parallel%task) RETURN
+
+  ! The fused kernel also computes the EOS and viscosity for this chunk
+  ocl_fused = 0
+  IF(fused) ocl_fused = 1
+
+  ! In async mode the result is only waited for in calc_dt_collect
+  ocl_async = 0
+  IF(OpenCL_async_dt) ocl_async = 1
+
+  CALL calc_dt_kernel_ocl(chunks(chunk)%field%x_min,     &
+                       chunks(chunk)%field%x_max,     &
+                       chunks(chunk)%field%y_min,     &
+                       chunks(chunk)%field%y_max,     &
+                       ocl_fused,                     &
+                       ocl_async                      )
+
+END SUBROUTINE calc_dt_enqueue
+
+SUBROUTINE calc_dt_collect(chunk,member,local_dt,local_control,xl_pos,yl_pos,jldt,kldt)
+
+  USE clover_module
+
+  IMPLICIT NONE
+
+  INTEGER          :: chunk
+  INTEGER          :: member ! Ensemble member, 1 without an ensemble
   REAL(KIND=8)     :: local_dt
   CHARACTER(LEN=8) :: local_control
   REAL(KIND=8)     :: xl_pos,yl_pos
@@ -44,27 +76,15 @@ SUBROUTINE calc_dt(chunk,local_dt,local_control,xl_pos,yl_pos,jldt,kldt)
 
   small = 0
 
-  CALL calc_dt_kernel_ocl(chunks(chunk)%field%x_min,     &
-                       chunks(chunk)%field%x_max,     &
-                       chunks(chunk)%field%y_min,     &
-                       chunks(chunk)%field%y_max,     &
-                       dtmin,                         &
-                       !chunks(chunk)%field%cellx,     &
-                       !chunks(chunk)%field%celly,     &
-                       !chunks(chunk)%field%density0,  &
-                       !chunks(chunk)%field%energy0,   &
-                       !chunks(chunk)%field%pressure,  &
-                       !chunks(chunk)%field%viscosity, &
-                       !chunks(chunk)%field%soundspeed,&
-                       !chunks(chunk)%field%xvel0,     &
-                       !chunks(chunk)%field%yvel0,     &
-                       local_dt,                      &
-                       l_control,                     &
-                       xl_pos,                        &
-                       yl_pos,                        &
-                       jldt,                          &
-                       kldt,                          &
-                       small                          )
+  CALL calc_dt_collect_kernel_ocl(member,                        &
+                               dtmin,                         &
+                               local_dt,                      &
+                               l_control,                     &
+                               xl_pos,                        &
+                               yl_pos,                        &
+                               jldt,                          &
+                               kldt,                          &
+                               small                          )
 
 
   IF(l_control.EQ.1) local_control='sound'
@@ -72,6 +92,6 @@ SUBROUTINE calc_dt(chunk,local_dt,local_control,xl_pos,yl_pos,jldt,kldt)
   IF(l_control.EQ.3) local_control='yvel'
   IF(l_control.EQ.4) local_control='div'
 
-END SUBROUTINE calc_dt
+END SUBROUTINE calc_dt_collect
 
 END MODULE calc_dt_module
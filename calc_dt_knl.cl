@@ -25,6 +25,50 @@
 
 #include "ocl_knls.h"
 
+/* dt, j, k, control, x and y of the limiting cell */
+#define DT_RESULT_SIZE 6
+
+/*
+ *  Writes the minimum and the limiting cell of its packed location into
+ *  dt_result, row_offset being the member's first row of celly
+ */
+inline void calc_dt_decode_result(
+        const double dt_min,
+        const int loc,
+        const int row_offset,
+        __global const field_t * restrict cellx,
+        __global const field_t * restrict celly,
+        __global double * restrict dt_result)
+{
+    int j = (loc/4) % XMAX + 2;
+    int k = (loc/4) / XMAX + 2;
+
+    dt_result[0] = dt_min;
+    dt_result[1] = j-1;
+    dt_result[2] = k-1;
+    dt_result[3] = loc%4 + 1;
+    dt_result[4] = cellx[j];
+    dt_result[5] = celly[k + row_offset];
+}
+
+/*
+ *  Minimum and location of the group partials first, first+WORKGROUP_SIZE, ...
+ *  the share one work item of the last group reduces
+ */
+inline void calc_dt_partials_min(__global const volatile double * dt_partials, const int num_groups,
+                                 const int first, const double g_big, double * dt_min, int * loc)
+{
+    *dt_min = g_big;
+    *loc = 0;
+
+    for (int group = first; group < num_groups; group += WORKGROUP_SIZE) {
+        if (dt_partials[2*group] < *dt_min) {
+            *dt_min = dt_partials[2*group];
+            *loc = (int) dt_partials[2*group+1];
+        }
+    }
+}
+
 __kernel void calc_dt_ocl_kernel(
         const double g_small,
         const double g_big,
@@ -33,110 +77,235 @@ __kernel void calc_dt_ocl_kernel(
         const double dtu_safe,              
         const double dtv_safe,              
         const double dtdiv_safe,            
-        __global const double * restrict xarea,
-        __global const double * restrict yarea,
-        __global const double * restrict cellx,
-        __global const double * restrict celly,
-        __global const double * restrict celldx,
-        __global const double * restrict celldy,
-        __global const double * restrict volume,
-        __global const double * restrict density0,
-        __global const double * restrict energy0,
-        __global const double * restrict pressure,
-        __global const double * restrict viscosity,
-        __global const double * restrict soundspeed,
-        __global const double * restrict xvel0,
-        __global const double * restrict yvel0,
-	    __global double * restrict dt_min_val_array)
+        __global const field_t * restrict xarea,
+        __global const field_t * restrict yarea,
+        __global const field_t * restrict cellx,
+        __global const field_t * restrict celly,
+        __global const field_t * restrict celldx,
+        __global const field_t * restrict celldy,
+        __global const field_t * restrict volume,
+        __global const field_t * restrict density0,
+        __global const field_t * restrict energy0,
+        __global const field_t * restrict pressure,
+        __global const field_t * restrict viscosity,
+        __global const field_t * restrict soundspeed,
+        __global const field_t * restrict xvel0,
+        __global const field_t * restrict yvel0,
+	    __global double * restrict dt_min_val_array,
+        __global double * restrict dt_min_loc_array)
 {
-    double dsx,dsy,cc,dv1,dv2,div,dtct,dtut,dtvt,dtdivt; 
+    int control;
 
     __local double dt_min_local[WORKGROUP_SIZE];
+    __local int dt_loc_local[WORKGROUP_SIZE];
 
     int k = get_global_id(1);
     int j = get_global_id(0);
 
     int localid = get_local_id(1)*get_local_size(0)+get_local_id(0);
     dt_min_local[localid] = 100000;
+    dt_loc_local[localid] = 0;
 
     dt_min_val_array[ARRAYXY(j,k,XMAXPLUSFIVE)] = g_big;
 
     if ( (j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE) ) {
 
-        dsx = celldx[j];
-        dsy = celldy[k];
+	    dt_min_local[localid] = calc_dt_cell(j, k, g_small, g_big, dtc_safe, dtu_safe, dtv_safe, dtdiv_safe,
+                                             soundspeed[ARRAYXY(j,k,XMAXPLUSFOUR)],
+                                             viscosity[ARRAYXY(j,k,XMAXPLUSFOUR)],
+                                             density0[ARRAYXY(j,k,XMAXPLUSFOUR)],
+                                             xarea, yarea, celldx, celldy, volume, xvel0, yvel0, &control);
 
-        cc = pow( soundspeed[ARRAYXY(j,k,XMAXPLUSFOUR)], 2);
-        cc = cc + 2.0 * viscosity[ARRAYXY(j,k,XMAXPLUSFOUR)] / density0[ARRAYXY(j,k,XMAXPLUSFOUR)];
-        cc = fmax(sqrt(cc),g_small);
+        dt_loc_local[localid] = calc_dt_location(j, k, control);
 
-        dtct = dtc_safe * fmin(dsx,dsy)/cc;
+    }
 
-        div = 0.0;
+    calc_dt_workgroup_min(dt_min_local, dt_loc_local, localid);
 
-        dv1 = (xvel0[ARRAYXY(j  ,k, XMAXPLUSFIVE)]+xvel0[ARRAYXY(j  ,k+1, XMAXPLUSFIVE)])
-              * xarea[ARRAYXY(j, k, XMAXPLUSFIVE )];
+    if (localid==0) { 
+        dt_min_val_array[get_group_id(1)*get_num_groups(0) + get_group_id(0)] = dt_min_local[0]; 
+        dt_min_loc_array[get_group_id(1)*get_num_groups(0) + get_group_id(0)] = dt_loc_local[0]; 
+    }
+}
 
-        dv2 = (xvel0[ARRAYXY(j+1, k, XMAXPLUSFIVE)]+ xvel0[ARRAYXY(j+1, k+1, XMAXPLUSFIVE)])
-              * xarea[ARRAYXY(j+1, k, XMAXPLUSFIVE)];
+#if ENSEMBLE_MEMBERS > 1
 
-        div = div + dv2 - dv1;
+/*
+ *  Minimum timestep of every ensemble member in one launch, with a third
+ *  dimension over the members. The work groups of a member write their
+ *  minimum and location as partials and the last of them to finish reduces
+ *  those, as in field_summary_ocl_kernel, then decodes the member's limiting
+ *  cell into its run of the dt result. j and k are numbered within the member
+ */
+__kernel void calc_dt_ensemble_ocl_kernel(
+        const double g_small,
+        const double g_big,
+        const double dtc_safe,              
+        const double dtu_safe,              
+        const double dtv_safe,              
+        const double dtdiv_safe,            
+        __global const field_t * restrict xarea,
+        __global const field_t * restrict yarea,
+        __global const field_t * restrict cellx,
+        __global const field_t * restrict celly,
+        __global const field_t * restrict celldx,
+        __global const field_t * restrict celldy,
+        __global const field_t * restrict volume,
+        __global const field_t * restrict density0,
+        __global const field_t * restrict viscosity,
+        __global const field_t * restrict soundspeed,
+        __global const field_t * restrict xvel0,
+        __global const field_t * restrict yvel0,
+        __global volatile double * dt_partials,
+        __global volatile int * group_counter,
+        __global double * restrict dt_result)
+{
+    int control, loc;
+    double dt_min;
 
-        dtut = dtu_safe * 2.0 * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] 
-	           / fmax(fabs(dv1), fmax( fabs(dv2), g_small * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] ) );
+    __local double dt_min_local[WORKGROUP_SIZE];
+    __local int dt_loc_local[WORKGROUP_SIZE];
+    __local int last_group;
 
-        dv1 = ( yvel0[ARRAYXY(j, k, XMAXPLUSFIVE)]+yvel0[ARRAYXY(j+1, k, XMAXPLUSFIVE)])
-              * yarea[ARRAYXY(j, k, XMAXPLUSFOUR)];
+    int member = get_global_id(2);
+    int member_k = get_global_id(1);
+    int k = member_k + member*MEMBER_ROWS;
+    int j = get_global_id(0);
 
-        dv2 = ( yvel0[ARRAYXY(j, k+1, XMAXPLUSFIVE)] + yvel0[ARRAYXY(j+1, k+1, XMAXPLUSFIVE)]) 
-              * yarea[ARRAYXY(j, k+1, XMAXPLUSFOUR)];
+    int localid = get_local_id(1)*get_local_size(0)+get_local_id(0);
+    int num_groups = get_num_groups(0)*get_num_groups(1);
 
-        div = div + dv2 - dv1; 
+    dt_partials += 2*num_groups*member;
+    group_counter += member;
+    dt_result += DT_RESULT_SIZE*member;
 
-        dtvt = dtv_safe * 2.0 * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] 
-	           / fmax( fabs(dv1), fmax( fabs(dv2), g_small * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] ) );
+    dt_min_local[localid] = g_big;
+    dt_loc_local[localid] = 0;
 
-        div = div / ( 2.0 * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] );
+    if ( (j>=2) && (j<=XMAXPLUSONE) && (member_k>=2) && (member_k<=MEMBER_YMAX+1) ) {
 
-        if (div < (-1*g_small)) {
-	        dtdivt = dtdiv_safe * (-1.0/div); 
-	    } else {
-            dtdivt = g_big;
-	    }
+        dt_min_local[localid] = calc_dt_cell(j, k, g_small, g_big, dtc_safe, dtu_safe, dtv_safe, dtdiv_safe,
+                                             soundspeed[ARRAYXY(j,k,XMAXPLUSFOUR)],
+                                             viscosity[ARRAYXY(j,k,XMAXPLUSFOUR)],
+                                             density0[ARRAYXY(j,k,XMAXPLUSFOUR)],
+                                             xarea, yarea, celldx, celldy, volume, xvel0, yvel0, &control);
 
-	    dt_min_local[localid] = fmin( fmin( fmin(dtvt, dtdivt), dtut ), dtct ); 
+        dt_loc_local[localid] = calc_dt_location(j, member_k, control);
+    }
 
+    calc_dt_workgroup_min(dt_min_local, dt_loc_local, localid);
+
+    if (localid==0) {
+
+        int group = get_group_id(1)*get_num_groups(0) + get_group_id(0);
+
+        dt_partials[2*group] = dt_min_local[0];
+        dt_partials[2*group+1] = dt_loc_local[0];
+
+        write_mem_fence(CLK_GLOBAL_MEM_FENCE);
+        last_group = (atomic_inc(group_counter) == num_groups-1);
     }
 
-#ifdef GPU_REDUCTION 
+    barrier(CLK_LOCAL_MEM_FENCE);
 
-        //GPU reduction 
-        barrier(CLK_LOCAL_MEM_FENCE);
+    if (last_group) {
+        read_mem_fence(CLK_GLOBAL_MEM_FENCE);
+
+        calc_dt_partials_min(dt_partials, num_groups, localid, g_big, &dt_min, &loc);
+
+        dt_min_local[localid] = dt_min;
+        dt_loc_local[localid] = loc;
 
-        for (int limit = WORKGROUP_SIZE_DIVTWO; limit > 0; limit >>= 1 ) {
+        calc_dt_workgroup_min(dt_min_local, dt_loc_local, localid);
 
-            if (localid < limit) {
-            
-                dt_min_local[localid] = fmin(dt_min_local[localid], dt_min_local[localid + limit]);
+        if (localid==0) {
+            calc_dt_decode_result(dt_min_local[0], dt_loc_local[0], member*MEMBER_ROWS, cellx, celly, dt_result);
 
-            }
-            barrier(CLK_LOCAL_MEM_FENCE);
+            group_counter[0] = 0;
         }
+    }
+}
 
-#else
+#endif
+
+
+
+/*
+ *  Finds the work group that produced the reduced minimum timestep and decodes
+ *  the cell and limiting condition it recorded, so the host reads back one
+ *  small result instead of decoding the location itself. Launched as a single
+ *  work group of WORKGROUP_SIZE work items.
+ */
+__kernel void calc_dt_locate_ocl_kernel(
+        const int num_groups,
+        __global const field_t * restrict cellx,
+        __global const field_t * restrict celly,
+        __global const double * restrict dt_min_val,
+        __global const double * restrict dt_min_val_array,
+        __global const double * restrict dt_min_loc_array,
+        __global double * restrict dt_result)
+{
+    __local int group_local[WORKGROUP_SIZE];
+
+    int localid = get_local_id(0);
+    int group = num_groups;
+
+    double dt_min = dt_min_val[0];
+
+    // the reduction returns one of the group minima exactly, so test equality
+    for (int index = localid; index < num_groups; index += WORKGROUP_SIZE) {
+        if (dt_min_val_array[index] == dt_min) {
+            group = index;
+            break;
+        }
+    }
+
+    group_local[localid] = group;
+
+#ifdef GPU_REDUCTION 
 
-        //CPU reduction 
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (int limit = WORKGROUP_SIZE_DIVTWO; limit > 0; limit >>= 1 ) {
+
+        if (localid < limit) {
+            group_local[localid] = min(group_local[localid], group_local[localid + limit]);
+        }
         barrier(CLK_LOCAL_MEM_FENCE);
+    }
 
-        if (localid==0) {
-            for (int index = 1; index < WORKGROUP_SIZE; index++) {
-                dt_min_local[localid] = fmin( dt_min_local[localid], dt_min_local[index] );  
-            }
+#else
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (localid==0) {
+        for (int index = 1; index < WORKGROUP_SIZE; index++) {
+            group_local[localid] = min( group_local[localid], group_local[index] );  
         }
+    }
 
 #endif
 
-    if (localid==0) { dt_min_val_array[get_group_id(1)*get_num_groups(0) + get_group_id(0)] = dt_min_local[0]; }
-}
+    if (localid==0) {
+
+        int loc = (group_local[0] < num_groups) ? (int) dt_min_loc_array[group_local[0]] : 0;
 
+        calc_dt_decode_result(dt_min, loc, 0, cellx, celly, dt_result);
+    }
+}
 
+/*
+ * Limits the chunk minimum as the host does for a single chunk and keeps the
+ * result as the dt the following kernels of the step read, so a replayed
+ * step never needs the host to pass dt in. The previous dt is the dtold.
+ */
+__kernel void calc_dt_finalise_ocl_kernel(
+        const double dtrise,
+        const double dtmax,
+        __global const double * restrict dt_result,
+        __global double * restrict dt_value)
+{
+    if (get_global_id(0) == 0) {
+        dt_value[0] = fmin(dt_result[0], fmin(dt_value[0]*dtrise, dtmax));
+    }
+}
@@ -0,0 +1,76 @@
+!Crown Copyright 2012 AWE.
+!
+! This file is part of CloverLeaf.
+!
+! CloverLeaf is free software: you can redistribute it and/or modify it under
+! the terms of the GNU General Public License as published by the
+! Free Software Foundation, either version 3 of the License, or (at your option)
+! any later version.
+!
+! CloverLeaf is distributed in the hope that it will be useful, but
+! WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+! FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+! details.
+!
+! You should have received a copy of the GNU General Public License along with
+! CloverLeaf. If not, see http://www.gnu.org/licenses/.
+
+!>  @brief Writes and restores checkpoints.
+!>  @details Each chunk's state fields are written from the card to a binary
+!>  file in checkpoint_path, together with the step, time, timesteps and sweep
+!>  direction. The write happens in the background while the run continues.
+!>  A restart reads the files straight back into the card's buffers.
+
+SUBROUTINE checkpoint
+
+  USE clover_module
+  USE report_module
+
+  IMPLICIT NONE
+
+  INTEGER :: c,ocl_advect_x
+
+  IF(.NOT.use_OpenCL_kernels) CALL report_error('checkpoint','Checkpointing requires use_opencl_kernels')
+
+  ocl_advect_x=0
+  IF(advect_x) ocl_advect_x=1
+
+  DO c = 1, number_of_chunks
+    IF(chunks(c)%task.EQ.parallel%task) THEN
+      ! Append //char(0) to hack around C/Fortran interop
+      CALL ocl_write_checkpoint(c,step,time,dt,dtold,ocl_advect_x,TRIM(checkpoint_path)//char(0))
+    ENDIF
+  ENDDO
+
+  IF(parallel%boss) WRITE(g_out,*) 'Checkpoint started at step ',step
+
+END SUBROUTINE checkpoint
+
+SUBROUTINE restore_checkpoint
+
+  USE clover_module
+  USE report_module
+
+  IMPLICIT NONE
+
+  INTEGER :: c,ocl_advect_x,err
+
+  IF(.NOT.use_OpenCL_kernels) CALL report_error('restore_checkpoint','Restarting requires use_opencl_kernels')
+
+  DO c = 1, number_of_chunks
+    IF(chunks(c)%task.EQ.parallel%task) THEN
+      CALL ocl_read_checkpoint(c,step,time,dt,dtold,ocl_advect_x,TRIM(checkpoint_path)//char(0),err)
+      IF(err.EQ.1) CALL report_error('restore_checkpoint','Could not read checkpoint file')
+      IF(err.EQ.2) CALL report_error('restore_checkpoint','Checkpoint was written for a different decomposition')
+      IF(err.EQ.3) CALL report_error('restore_checkpoint','Checkpoint was written by a build with a different field precision')
+    ENDIF
+  ENDDO
+
+  advect_x=(ocl_advect_x.EQ.1)
+
+  IF(parallel%boss) THEN
+    WRITE(g_out,*)
+    WRITE(g_out,*) 'Restarted from checkpoint at step ',step,' time ',time
+  ENDIF
+
+END SUBROUTINE restore_checkpoint
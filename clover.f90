@@ -105,22 +105,28 @@ SUBROUTINE clover_get_num_chunks(count)
 
 END SUBROUTINE clover_get_num_chunks
 
-SUBROUTINE clover_decompose(x_cells,y_cells,left,right,bottom,top)
+SUBROUTINE clover_decompose(x_cells,y_cells,left,right,bottom,top,weights)
 
   ! This decomposes the mesh into a number of chunks.
   ! The number of chunks may be a multiple of the number of mpi tasks
   ! Doesn't always return the best split if there are few factors
   ! All factors need to be stored and the best picked. But its ok for now
+  ! With weights, the relative throughput of each chunk, each column and row
+  ! of chunks is sized in proportion to its total weight instead of equally
 
   IMPLICIT NONE
 
   INTEGER :: x_cells,y_cells,left(:),right(:),top(:),bottom(:)
+  REAL(KIND=8), OPTIONAL :: weights(:)
   INTEGER :: c,delta_x,delta_y
 
   REAL(KIND=8) :: mesh_ratio,factor_x,factor_y
   INTEGER  :: chunk_x,chunk_y,mod_x,mod_y,split_found
 
-  INTEGER  :: cx,cy,chunk,add_x,add_y,add_x_prev,add_y_prev
+  INTEGER  :: cx,cy,chunk,add_x_prev,add_y_prev
+
+  INTEGER, ALLOCATABLE :: width_x(:),width_y(:)
+  REAL(KIND=8), ALLOCATABLE :: weight_x(:),weight_y(:)
 
   ! 2D Decomposition of the mesh
 
@@ -159,6 +165,32 @@ SUBROUTINE clover_decompose(x_cells,y_cells,left,right,bottom,top)
   mod_x=MOD(x_cells,chunk_x)
   mod_y=MOD(y_cells,chunk_y)
 
+  ALLOCATE(width_x(chunk_x),width_y(chunk_y))
+
+  IF(PRESENT(weights)) THEN
+    ALLOCATE(weight_x(chunk_x),weight_y(chunk_y))
+    weight_x=0.0_8
+    weight_y=0.0_8
+    DO cy=1,chunk_y
+      DO cx=1,chunk_x
+        weight_x(cx)=weight_x(cx)+weights(chunk_x*(cy-1)+cx)
+        weight_y(cy)=weight_y(cy)+weights(chunk_x*(cy-1)+cx)
+      ENDDO
+    ENDDO
+    CALL clover_weighted_split(x_cells,chunk_x,weight_x,width_x)
+    CALL clover_weighted_split(y_cells,chunk_y,weight_y,width_y)
+    DEALLOCATE(weight_x,weight_y)
+  ELSE
+    DO cx=1,chunk_x
+      width_x(cx)=delta_x
+      IF(cx.LE.mod_x)width_x(cx)=delta_x+1
+    ENDDO
+    DO cy=1,chunk_y
+      width_y(cy)=delta_y
+      IF(cy.LE.mod_y)width_y(cy)=delta_y+1
+    ENDDO
+  ENDIF
+
   ! Set up chunk mesh ranges and chunk connectivity
 
   add_x_prev=0
@@ -166,14 +198,10 @@ SUBROUTINE clover_decompose(x_cells,y_cells,left,right,bottom,top)
   chunk=1
   DO cy=1,chunk_y
     DO cx=1,chunk_x
-      add_x=0
-      add_y=0
-      IF(cx.LE.mod_x)add_x=1
-      IF(cy.LE.mod_y)add_y=1
-      left(chunk)=(cx-1)*delta_x+1+add_x_prev
-      right(chunk)=left(chunk)+delta_x-1+add_x
-      bottom(chunk)=(cy-1)*delta_y+1+add_y_prev
-      top(chunk)=bottom(chunk)+delta_y-1+add_y
+      left(chunk)=add_x_prev+1
+      right(chunk)=left(chunk)+width_x(cx)-1
+      bottom(chunk)=add_y_prev+1
+      top(chunk)=bottom(chunk)+width_y(cy)-1
       chunks(chunk)%chunk_neighbours(chunk_left)=chunk_x*(cy-1)+cx-1
       chunks(chunk)%chunk_neighbours(chunk_right)=chunk_x*(cy-1)+cx+1
       chunks(chunk)%chunk_neighbours(chunk_bottom)=chunk_x*(cy-2)+cx
@@ -182,22 +210,57 @@ SUBROUTINE clover_decompose(x_cells,y_cells,left,right,bottom,top)
       IF(cx.EQ.chunk_x)chunks(chunk)%chunk_neighbours(chunk_right)=external_face
       IF(cy.EQ.1)chunks(chunk)%chunk_neighbours(chunk_bottom)=external_face
       IF(cy.EQ.chunk_y)chunks(chunk)%chunk_neighbours(chunk_top)=external_face
-      IF(cx.LE.mod_x)add_x_prev=add_x_prev+1
+      add_x_prev=add_x_prev+width_x(cx)
       chunk=chunk+1
     ENDDO
     add_x_prev=0
-    IF(cy.LE.mod_y)add_y_prev=add_y_prev+1
+    add_y_prev=add_y_prev+width_y(cy)
   ENDDO
 
   IF(parallel%boss)THEN
     WRITE(g_out,*)
     WRITE(g_out,*)"Mesh ratio of ",mesh_ratio
     WRITE(g_out,*)"Decomposing the mesh into ",chunk_x," by ",chunk_y," chunks"
+    IF(PRESENT(weights)) THEN
+      WRITE(g_out,*)"Chunk column widths ",width_x
+      WRITE(g_out,*)"Chunk row heights   ",width_y
+    ENDIF
     WRITE(g_out,*)
   ENDIF
 
+  DEALLOCATE(width_x,width_y)
+
 END SUBROUTINE clover_decompose
 
+SUBROUTINE clover_weighted_split(cells,parts,weights,widths)
+
+  ! Splits cells into parts in proportion to weights, keeping at least two
+  ! cells in every part for the halo exchange
+
+  IMPLICIT NONE
+
+  INTEGER :: cells,parts,widths(:)
+  REAL(KIND=8) :: weights(:)
+
+  INTEGER :: p,edge,last_edge
+  REAL(KIND=8) :: total,running
+
+  total=SUM(weights)
+  running=0.0_8
+  last_edge=0
+
+  DO p=1,parts
+    running=running+weights(p)
+    edge=NINT(cells*running/total)
+    edge=MAX(edge,last_edge+2)
+    edge=MIN(edge,cells-2*(parts-p))
+    IF(p.EQ.parts) edge=cells
+    widths(p)=edge-last_edge
+    last_edge=edge
+  ENDDO
+
+END SUBROUTINE clover_weighted_split
+
 SUBROUTINE clover_allocate_buffers(chunk)
 
   IMPLICIT NONE
@@ -207,6 +270,13 @@ SUBROUTINE clover_allocate_buffers(chunk)
   ! Unallocated buffers for external boundaries caused issues on some systems so they are now
   !  all allocated
   IF(parallel%task.EQ.chunks(chunk)%task)THEN
+    ! A rebalanced decomposition sets the chunk up again with its new size
+    IF(ALLOCATED(chunks(chunk)%left_snd_buffer)) THEN
+      DEALLOCATE(chunks(chunk)%left_snd_buffer,chunks(chunk)%left_rcv_buffer)
+      DEALLOCATE(chunks(chunk)%right_snd_buffer,chunks(chunk)%right_rcv_buffer)
+      DEALLOCATE(chunks(chunk)%bottom_snd_buffer,chunks(chunk)%bottom_rcv_buffer)
+      DEALLOCATE(chunks(chunk)%top_snd_buffer,chunks(chunk)%top_rcv_buffer)
+    ENDIF
     !IF(chunks(chunk)%chunk_neighbours(chunk_left).NE.external_face) THEN
       ALLOCATE(chunks(chunk)%left_snd_buffer(2*(chunks(chunk)%field%y_max+5)))
       ALLOCATE(chunks(chunk)%left_rcv_buffer(2*(chunks(chunk)%field%y_max+5)))
@@ -233,6 +303,11 @@ SUBROUTINE clover_exchange(fields,depth)
 
   INTEGER      :: fields(:),depth
 
+  IF(OpenCL_pipelined_exchange) THEN
+    CALL clover_exchange_pipelined(fields,depth)
+    RETURN
+  ENDIF
+
   ! Assuming 1 patch per task, this will be changed
   ! Also, not packing all fields for each communication, doing one at a time
 
@@ -434,6 +509,28 @@ SUBROUTINE clover_exchange(fields,depth)
 
 END SUBROUTINE clover_exchange
 
+SUBROUTINE clover_exchange_pipelined(fields,depth)
+
+  IMPLICIT NONE
+
+  INTEGER      :: fields(:),depth
+  INTEGER      :: chunk,face,neighbour_tasks(4)
+
+  ! All requested fields go in one message per face, packed and unpacked on the device
+  chunk=parallel%task+1
+
+  DO face=1,4
+    IF(chunks(chunk)%chunk_neighbours(face).NE.external_face) THEN
+      neighbour_tasks(face)=chunks(chunks(chunk)%chunk_neighbours(face))%task
+    ELSE
+      neighbour_tasks(face)=-1
+    ENDIF
+  ENDDO
+
+  CALL exchange_comms_buffers_pipelined_ocl(chunk,chunks(chunk)%chunk_neighbours,neighbour_tasks,fields,depth)
+
+END SUBROUTINE clover_exchange_pipelined
+
 SUBROUTINE clover_exchange_message(chunk,field,                            &
                                    left_snd_buffer,                        &
                                    left_rcv_buffer,                        &
@@ -719,6 +816,19 @@ SUBROUTINE clover_min(value)
 
 END SUBROUTINE clover_min
 
+SUBROUTINE clover_allgather(value,values)
+
+  IMPLICIT NONE
+
+  REAL(KIND=8) :: value
+  REAL(KIND=8) :: values(parallel%max_task)
+
+  INTEGER :: err
+
+  CALL MPI_ALLGATHER(value,1,MPI_DOUBLE_PRECISION,values,1,MPI_DOUBLE_PRECISION,MPI_COMM_WORLD,err)
+
+END SUBROUTINE clover_allgather
+
 SUBROUTINE clover_check_error(error)
 
   IMPLICIT NONE
@@ -2,4 +2,13 @@
     CloverCL::outoforder_queue.enqueueNDRangeKernel(kernel, cl::NullRange, \
                                                     cl::NDRange(x_num, y_num), \
                                                     cl::NDRange(x_wg_size,y_wg_size), \
-                                                    NULL, NULL);
+                                                    NULL, CloverCL::profiledEvent()); \
+    CloverCL::recordKernelEvent(kernel, CloverCL::profile_event, (x_num)*(y_num)); \
+    CloverCL::recordStepLaunch(kernel, cl::NullRange, cl::NDRange(x_num, y_num), \
+                               cl::NDRange(x_wg_size,y_wg_size));
+
+// face bits understood by the batched halo and pipelined exchange kernels, as in ocl_knls.h
+#define HALO_FACE_BOTTOM 1
+#define HALO_FACE_TOP    2
+#define HALO_FACE_LEFT   4
+#define HALO_FACE_RIGHT  8
@@ -49,6 +49,10 @@ MODULE definitions_module
    TYPE(state_type), ALLOCATABLE             :: states(:)
    INTEGER                                   :: number_of_states
 
+   INTEGER                                   :: number_of_members ! Decks run side by side as one stacked chunk, 1 without an ensemble
+   CHARACTER(LEN=80), ALLOCATABLE            :: ensemble_decks(:) ! Input deck of each ensemble member, the first being clover.in
+   TYPE(state_type), ALLOCATABLE             :: member_states(:,:) ! States of each member, padded to number_of_states
+
    TYPE grid_type
      REAL(KIND=8)       :: xmin            &
                           ,ymin            &
@@ -72,12 +76,29 @@ MODULE definitions_module
    LOGICAL      :: use_C_kernels
    LOGICAL      :: use_OA_kernels
    LOGICAL      :: use_OpenCL_kernels
+   LOGICAL      :: use_native_kernels ! Run the OpenCL kernel sources as host loops, needs a NATIVE=1 build
 
    LOGICAL      :: use_vector_loops ! Some loops work better in serial depending on the hardware
 
    CHARACTER(LEN=12) :: OpenCL_vendor
    CHARACTER(LEN=12) :: OpenCL_type
 
+   LOGICAL      :: OpenCL_autotune ! Sweep local work-group sizes at start up, cached per device and mesh
+   LOGICAL      :: OpenCL_fused_timestep ! Compute EOS, viscosity and dt in a single kernel pass
+   LOGICAL      :: OpenCL_async_dt ! Read the dt result back asynchronously, only waiting before clover_min
+   LOGICAL      :: OpenCL_single_reduction ! Use the single launch reduction kernels instead of the tree
+   LOGICAL      :: OpenCL_batched_halo ! Update all requested fields' halos in one launch per pair of faces
+   LOGICAL      :: OpenCL_pipelined_exchange ! Exchange all requested fields in one message per face, overlapping copies with MPI
+   LOGICAL      :: OpenCL_pinned_staging ! Stage host transfers through mapped pinned memory, mapped directly on CPU devices
+   LOGICAL      :: OpenCL_buffer_swap ! Swap time level buffers in reset_field instead of copying, and skip revert
+   LOGICAL      :: OpenCL_fused_advec_cell ! Run each advec_cell sweep as one tiled kernel
+   LOGICAL      :: OpenCL_fused_advec_mom ! Advect both velocities in one tiled kernel per advec_mom sweep
+   LOGICAL      :: OpenCL_binary_vis ! Write binary VTK dumps on a background thread
+   LOGICAL      :: OpenCL_event_profile ! Profile kernels and transfers from their events into a Chrome trace
+   LOGICAL      :: OpenCL_step_replay ! Record the launches of a step once per sweep order and replay them, single chunk only
+   LOGICAL      :: OpenCL_async_summary ! Launch the field summary without waiting, reporting it at the end of the next step
+   LOGICAL      :: OpenCL_interior_tiles ! Run the point-wise kernels guard-free over whole work-groups, guarded over the remainder
+
 
    REAL(KIND=8) :: end_time
 
@@ -100,7 +121,23 @@ MODULE definitions_module
                   ,dtdiv
 
    INTEGER      :: visit_frequency   &
-                  ,summary_frequency
+                  ,summary_frequency &
+                  ,checkpoint_frequency
+
+   CHARACTER(LEN=80) :: checkpoint_path ! Directory the per chunk checkpoint files are written to and restarted from
+   LOGICAL      :: restart_run ! Restore the state from the checkpoint in checkpoint_path before the first step
+
+   INTEGER      :: balance_calibration_steps ! Kernel passes timed to size the chunks by throughput, 0 for equal chunks
+   REAL(KIND=8) :: balance_tolerance ! Rebalance when the fastest chunk beats the slowest by more than this ratio
+
+   CHARACTER(LEN=80) :: summary_baseline ! Field summaries written by a double build, compared against by a mixed precision one
+
+   LOGICAL      :: summary_pending ! A field summary has been launched and not yet reported
+   INTEGER      :: summary_pending_step
+   REAL(KIND=8) :: summary_pending_time
+
+   REAL(KIND=8), ALLOCATABLE :: member_dt(:),member_dtold(:),member_time(:) ! Each ensemble member advances with its own dt
+   LOGICAL, ALLOCATABLE      :: member_active(:) ! Members yet to reach end_time, the others take zero steps
 
    INTEGER         :: jdt,kdt
 
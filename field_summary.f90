@@ -23,6 +23,11 @@
 !>  result and the difference output.
 !>  Note the reference solution is the value returned from an Intel compiler with
 !>  ieee options set on a single core crun.
+!>  With summary_baseline set a double build records every summary in that file
+!>  and a mixed precision build reports its relative drift from the recording.
+!>  With opencl_async_summary the summary is only launched here and reported by
+!>  field_summary_collect at the end of the next step, when it has long arrived.
+!>  An ensemble reports a summary for each member at its own time.
 
 SUBROUTINE field_summary()
 
@@ -31,67 +36,189 @@ SUBROUTINE field_summary()
 
   IMPLICIT NONE
 
-  REAL(KIND=8) :: vol,mass,ie,ke,press
-  REAL(KIND=8) :: qa_diff
-
-!$ INTEGER :: OMP_GET_THREAD_NUM
-
   INTEGER      :: c
+  INTEGER      :: ocl_async
 
-  IF(parallel%boss)THEN
-    WRITE(g_out,*)
-    WRITE(g_out,*) 'Time ',time
-    WRITE(g_out,'(a13,7a16)')'           ','Volume','Mass','Density','Pressure','Internal Energy','Kinetic Energy','Total Energy'
-  ENDIF
+  ! A summary still in flight is reported before the next one is started
+  IF(summary_pending) CALL field_summary_collect()
 
   DO c=1,number_of_chunks
     CALL ideal_gas(c,.FALSE.)
   ENDDO
 
+  ! The final summary is always waited for, it is checked against the test problem
+  ocl_async=0
+  IF(OpenCL_async_summary.AND..NOT.complete) ocl_async=1
+
   DO c=1,number_of_chunks
     IF(chunks(c)%task.EQ.parallel%task) THEN
       CALL field_summary_kernel_ocl(chunks(c)%field%x_min,                   &
                                 chunks(c)%field%x_max,                   &
                                 chunks(c)%field%y_min,                   &
                                 chunks(c)%field%y_max,                   &
-                                vol,mass,ie,ke,press                     )
-
+                                ocl_async                                )
     ENDIF
   ENDDO
 
-  ! For mpi I need a reduction here
-  CALL clover_sum(vol)
-  CALL clover_sum(mass)
-  CALL clover_sum(press)
-  CALL clover_sum(ie)
-  CALL clover_sum(ke)
-
-  IF(parallel%boss) THEN
-!$  IF(OMP_GET_THREAD_NUM().EQ.0) THEN
-      WRITE(g_out,'(a6,i7,7e16.4)')' step:',step,vol,mass,mass/vol,press/vol,ie,ke,ie+ke
-      WRITE(g_out,*)
-!$  ENDIF
-   ENDIF
-
-  !Check if this is the final call and if it is a test problem, check the result.
-  IF(complete) THEN
+  summary_pending=.TRUE.
+  summary_pending_step=step
+  summary_pending_time=time
+
+  IF(ocl_async.EQ.0) CALL field_summary_collect()
+
+END SUBROUTINE field_summary
+
+SUBROUTINE field_summary_collect()
+
+  USE clover_module
+
+  IMPLICIT NONE
+
+  REAL(KIND=8) :: vol,mass,ie,ke,press
+  REAL(KIND=8) :: qa_diff
+
+!$ INTEGER :: OMP_GET_THREAD_NUM
+
+  INTEGER      :: c
+  INTEGER      :: member
+
+  summary_pending=.FALSE.
+
+  ! Each ensemble member is reported on its own, the baseline and the test
+  ! problem only apply to the first
+  DO member=1,number_of_members
+
+    DO c=1,number_of_chunks
+      IF(chunks(c)%task.EQ.parallel%task) THEN
+        CALL field_summary_collect_kernel_ocl(member,vol,mass,ie,ke,press)
+      ENDIF
+    ENDDO
+
+    ! For mpi I need a reduction here
+    CALL clover_sum(vol)
+    CALL clover_sum(mass)
+    CALL clover_sum(press)
+    CALL clover_sum(ie)
+    CALL clover_sum(ke)
+
     IF(parallel%boss) THEN
 !$    IF(OMP_GET_THREAD_NUM().EQ.0) THEN
-        IF(test_problem.EQ.1) THEN
-          qa_diff=ABS((100.0_8*(ke/1.82280367310258_8))-100.0_8)
-          WRITE(*,*)"Test problem 1 is within",qa_diff,"% of the expected solution"
-          WRITE(g_out,*)"Test problem 1 is within",qa_diff,"% of the expected solution"
-          IF(qa_diff.LT.0.001) THEN
-            WRITE(*,*)"This test is considered PASSED"
-            WRITE(g_out,*)"This test is considered PASSED"
-          ELSE
-            WRITE(*,*)"This test is considered NOT PASSED"
-            WRITE(g_out,*)"This is test is considered NOT PASSED"
-          ENDIF
+        WRITE(g_out,*)
+        IF(number_of_members.GT.1) THEN
+          WRITE(g_out,*) 'Member ',member,' time ',member_time(member)
+        ELSE
+          WRITE(g_out,*) 'Time ',summary_pending_time
         ENDIF
+        WRITE(g_out,'(a13,7a16)')'           ','Volume','Mass','Density','Pressure','Internal Energy', &
+                                 'Kinetic Energy','Total Energy'
+        WRITE(g_out,'(a6,i7,7e16.4)')' step:',summary_pending_step,vol,mass,mass/vol,press/vol,ie,ke,ie+ke
+#ifdef CLOVER_MIXED_PRECISION
+        IF(summary_baseline.NE.''.AND.member.EQ.1) CALL field_summary_drift(summary_pending_step,vol,mass,press,ie,ke)
+#else
+        IF(summary_baseline.NE.''.AND.member.EQ.1) CALL field_summary_record(summary_pending_step,vol,mass,press,ie,ke)
+#endif
+        WRITE(g_out,*)
 !$    ENDIF
+     ENDIF
+
+    !Check if this is the final call and if it is a test problem, check the result.
+    IF(complete.AND.summary_pending_step.EQ.step.AND.member.EQ.1) THEN
+      IF(parallel%boss) THEN
+!$      IF(OMP_GET_THREAD_NUM().EQ.0) THEN
+          IF(test_problem.EQ.1) THEN
+            qa_diff=ABS((100.0_8*(ke/1.82280367310258_8))-100.0_8)
+            WRITE(*,*)"Test problem 1 is within",qa_diff,"% of the expected solution"
+            WRITE(g_out,*)"Test problem 1 is within",qa_diff,"% of the expected solution"
+            IF(qa_diff.LT.0.001) THEN
+              WRITE(*,*)"This test is considered PASSED"
+              WRITE(g_out,*)"This test is considered PASSED"
+            ELSE
+              WRITE(*,*)"This test is considered NOT PASSED"
+              WRITE(g_out,*)"This is test is considered NOT PASSED"
+            ENDIF
+          ENDIF
+!$      ENDIF
+      ENDIF
+    ENDIF
+
+  ENDDO
+
+
+END SUBROUTINE field_summary_collect
+
+SUBROUTINE field_summary_record(summ_step,vol,mass,press,ie,ke)
+
+  USE clover_module
+  USE report_module
+
+  IMPLICIT NONE
+
+  INTEGER      :: summ_step
+  REAL(KIND=8) :: vol,mass,press,ie,ke
+
+  INTEGER      :: get_unit,dummy,ios
+  INTEGER,SAVE :: u=-1
+
+  IF(u.LT.0) THEN
+    u=get_unit(dummy)
+    OPEN(FILE=TRIM(summary_baseline),UNIT=u,STATUS='REPLACE',ACTION='WRITE',IOSTAT=ios)
+    IF(ios.NE.0) CALL report_error('field_summary_record','Error opening the summary baseline file')
+  ENDIF
+
+  ! Full precision so the drift of a float run is not lost in the rounding
+  WRITE(u,'(i8,5es25.16)')summ_step,vol,mass,press,ie,ke
+  CALL FLUSH(u)
+
+END SUBROUTINE field_summary_record
+
+SUBROUTINE field_summary_drift(summ_step,vol,mass,press,ie,ke)
+
+  USE clover_module
+  USE report_module
+
+  IMPLICIT NONE
+
+  INTEGER      :: summ_step
+  REAL(KIND=8) :: vol,mass,press,ie,ke
+
+  INTEGER      :: get_unit,dummy,ios,base_step
+  INTEGER,SAVE :: u=-1
+  REAL(KIND=8) :: base_vol,base_mass,base_press,base_ie,base_ke
+
+  IF(u.LT.0) THEN
+    u=get_unit(dummy)
+    OPEN(FILE=TRIM(summary_baseline),UNIT=u,STATUS='OLD',ACTION='READ',IOSTAT=ios)
+    IF(ios.NE.0) CALL report_error('field_summary_drift','Error opening the summary baseline file')
+  ENDIF
+
+  ! Both runs summarise on the same steps, any the baseline skipped are passed over
+  DO
+    READ(u,*,IOSTAT=ios)base_step,base_vol,base_mass,base_press,base_ie,base_ke
+    IF(ios.NE.0) THEN
+      WRITE(g_out,'(a6,i7,a)')'drift:',summ_step,'     no baseline summary for this step'
+      RETURN
     ENDIF
+    IF(base_step.GE.summ_step) EXIT
+  ENDDO
+
+  IF(base_step.NE.summ_step) THEN
+    BACKSPACE(u)
+    WRITE(g_out,'(a6,i7,a)')'drift:',summ_step,'     no baseline summary for this step'
+    RETURN
   ENDIF
 
+  WRITE(g_out,'(a6,i7,7e16.4)')'drift:',summ_step,drift(vol,base_vol),drift(mass,base_mass),             &
+                                drift(mass/vol,base_mass/base_vol),drift(press/vol,base_press/base_vol), &
+                                drift(ie,base_ie),drift(ke,base_ke),drift(ie+ke,base_ie+base_ke)
 
-END SUBROUTINE field_summary
+CONTAINS
+
+  FUNCTION drift(value,baseline)
+
+    REAL(KIND=8) :: drift,value,baseline
+
+    drift=ABS(value-baseline)/MAX(ABS(baseline),g_small)
+
+  END FUNCTION drift
+
+END SUBROUTINE field_summary_drift
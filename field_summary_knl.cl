@@ -19,108 +19,171 @@
  *  @brief OCL device-side field summary kernel
  *  @author Andrew Mallinson, David Beckingsale, Wayne Gaudin
  *  @details The total mass, internal energy, kinetic energy and volume weighted
- *  pressure for the chunk is calculated.
+ *  pressure for the chunk is calculated. The five sums are reduced together in
+ *  one launch, each work group writing its partial sums and the last group to
+ *  finish adding them up, as in reduction_minimum_single_ocl_kernel. An
+ *  ensemble build launches it with a third dimension over the members, each
+ *  member reducing into its own counter and run of summary values.
  */
 
 #include "ocl_knls.h"
 
-__kernel void field_summary_ocl_kernel(
-    __global const double * restrict volume,
-    __global const double * restrict density0,
-    __global const double * restrict energy0,
-    __global const double * restrict pressure,
-    __global const double * restrict xvel0,
-    __global const double * restrict yvel0,
-    __global double * restrict vol_tmp_array,
-    __global double * restrict mass_tmp_array,
-    __global double * restrict ie_tmp_array,
-    __global double * restrict ke_tmp_array,
-    __global double * restrict press_tmp_array)
-{   
-
-    double vsqrd,cell_vol,cell_mass;
+/* volume, mass, internal energy, kinetic energy and pressure */
+#define FIELD_SUMMARY_VALUES 5
 
-    __local double vol_sum_local[WORKGROUP_SIZE];
-    __local double mass_sum_local[WORKGROUP_SIZE];
-    __local double ie_sum_local[WORKGROUP_SIZE];
-    __local double ke_sum_local[WORKGROUP_SIZE];
-    __local double press_sum_local[WORKGROUP_SIZE];
+/*
+ *  Work group sum of every value, the result is only valid on work item 0.
+ *  Each value has its own WORKGROUP_SIZE run of sum_local
+ */
+void field_summary_workgroup_sum(double * sums, __local double * restrict sum_local)
+{
+    int localid = get_local_id(1)*get_local_size(0)+get_local_id(0);
 
-    int k = get_global_id(1);
-    int j = get_global_id(0);
+    for (int v = 0; v < FIELD_SUMMARY_VALUES; v++) {
+        sum_local[v*WORKGROUP_SIZE + localid] = sums[v];
+    }
 
-    int localid = get_local_id(1)*get_local_size(0)+get_local_id(0);
+    barrier(CLK_LOCAL_MEM_FENCE);
 
-    vol_sum_local[localid] = 0;
-    mass_sum_local[localid]= 0;
-    ie_sum_local[localid] = 0;
-    ke_sum_local[localid] = 0;
-    press_sum_local[localid] = 0;
+#ifdef GPU_REDUCTION
 
-    if ( (j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE) ) {
+    for (int limit = WORKGROUP_SIZE_DIVTWO; limit > 0; limit >>= 1) {
 
-        vsqrd = 0.25 * ( pow(xvel0[ARRAYXY(j  ,k  , XMAXPLUSFIVE)], 2) + pow(yvel0[ARRAYXY(j  ,k  , XMAXPLUSFIVE)], 2) ) +
-	            0.25 * ( pow(xvel0[ARRAYXY(j+1,k  , XMAXPLUSFIVE)], 2) + pow(yvel0[ARRAYXY(j+1,k  , XMAXPLUSFIVE)], 2) ) +
-	            0.25 * ( pow(xvel0[ARRAYXY(j  ,k+1, XMAXPLUSFIVE)], 2) + pow(yvel0[ARRAYXY(j  ,k+1, XMAXPLUSFIVE)], 2) ) +
-	            0.25 * ( pow(xvel0[ARRAYXY(j+1,k+1, XMAXPLUSFIVE)], 2) + pow(yvel0[ARRAYXY(j+1,k+1, XMAXPLUSFIVE)], 2) );
+        if (localid < limit) {
+            for (int v = 0; v < FIELD_SUMMARY_VALUES; v++) {
+                sum_local[v*WORKGROUP_SIZE + localid] += sum_local[v*WORKGROUP_SIZE + localid + limit];
+            }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
 
-        cell_vol = volume[ARRAYXY(j, k, XMAXPLUSFOUR)];
-        cell_mass = cell_vol * density0[ARRAYXY(j, k, XMAXPLUSFOUR)];
+    for (int v = 0; v < FIELD_SUMMARY_VALUES; v++) {
+        sums[v] = sum_local[v*WORKGROUP_SIZE];
+    }
 
-        vol_sum_local[localid] = cell_vol;
-        mass_sum_local[localid] = cell_mass;
-        ie_sum_local[localid] = cell_mass * energy0[ARRAYXY(j, k, XMAXPLUSFOUR)]; 
-        ke_sum_local[localid] = cell_mass * 0.5 * vsqrd;
-        press_sum_local[localid] = cell_vol * pressure[ARRAYXY(j, k, XMAXPLUSFOUR)];
+#else
 
+    if (localid==0) {
+        for (int index = 1; index < WORKGROUP_SIZE; index++ ) {
+            for (int v = 0; v < FIELD_SUMMARY_VALUES; v++) {
+                sums[v] += sum_local[v*WORKGROUP_SIZE + index];
+            }
+        }
     }
 
+#endif
+}
 
-#ifdef GPU_REDUCTION
+/*
+ *  Volume, mass, internal energy, kinetic energy and volume weighted pressure
+ *  of cell j, k
+ */
+inline void field_summary_cell(
+    const int j,
+    const int k,
+    __global const field_t * restrict volume,
+    __global const field_t * restrict density0,
+    __global const field_t * restrict energy0,
+    __global const field_t * restrict pressure,
+    __global const field_t * restrict xvel0,
+    __global const field_t * restrict yvel0,
+    double * sums)
+{
+    double vsqrd,cell_vol,cell_mass;
 
-        //GPU reduction 
-        barrier(CLK_LOCAL_MEM_FENCE);
+    vsqrd = 0.25 * ( pow((double)xvel0[ARRAYXY(j  ,k  , XMAXPLUSFIVE)], 2) + pow((double)yvel0[ARRAYXY(j  ,k  , XMAXPLUSFIVE)], 2) ) +
+            0.25 * ( pow((double)xvel0[ARRAYXY(j+1,k  , XMAXPLUSFIVE)], 2) + pow((double)yvel0[ARRAYXY(j+1,k  , XMAXPLUSFIVE)], 2) ) +
+            0.25 * ( pow((double)xvel0[ARRAYXY(j  ,k+1, XMAXPLUSFIVE)], 2) + pow((double)yvel0[ARRAYXY(j  ,k+1, XMAXPLUSFIVE)], 2) ) +
+            0.25 * ( pow((double)xvel0[ARRAYXY(j+1,k+1, XMAXPLUSFIVE)], 2) + pow((double)yvel0[ARRAYXY(j+1,k+1, XMAXPLUSFIVE)], 2) );
 
-        for (int limit = WORKGROUP_SIZE_DIVTWO; limit > 0; limit >>= 1) {
+    cell_vol = volume[ARRAYXY(j, k, XMAXPLUSFOUR)];
+    cell_mass = cell_vol * density0[ARRAYXY(j, k, XMAXPLUSFOUR)];
 
-            if (localid < limit) {
+    sums[0] = cell_vol;
+    sums[1] = cell_mass;
+    sums[2] = cell_mass * energy0[ARRAYXY(j, k, XMAXPLUSFOUR)];
+    sums[3] = cell_mass * 0.5 * vsqrd;
+    sums[4] = cell_vol * pressure[ARRAYXY(j, k, XMAXPLUSFOUR)];
+}
 
-                vol_sum_local[localid] = vol_sum_local[localid] + vol_sum_local[localid + limit];
-                mass_sum_local[localid] = mass_sum_local[localid] + mass_sum_local[localid + limit];
-                ie_sum_local[localid] = ie_sum_local[localid] + ie_sum_local[localid + limit];
-                ke_sum_local[localid] = ke_sum_local[localid] + ke_sum_local[localid + limit];
-                press_sum_local[localid] = press_sum_local[localid] + press_sum_local[localid + limit];
-            }
-            barrier(CLK_LOCAL_MEM_FENCE);  
+/*
+ *  Sums of the group partials first, first+WORKGROUP_SIZE, ... the share one
+ *  work item of the last group adds up
+ */
+inline void field_summary_partials_sum(__global const volatile double * partial_sums, const int num_groups,
+                                       const int first, double * sums)
+{
+    for (int v = 0; v < FIELD_SUMMARY_VALUES; v++) {
+        sums[v] = 0.0;
+    }
+
+    for (int group = first; group < num_groups; group += WORKGROUP_SIZE) {
+        for (int v = 0; v < FIELD_SUMMARY_VALUES; v++) {
+            sums[v] += partial_sums[FIELD_SUMMARY_VALUES*group + v];
         }
+    }
+}
 
+__kernel void field_summary_ocl_kernel(
+    __global const field_t * restrict volume,
+    __global const field_t * restrict density0,
+    __global const field_t * restrict energy0,
+    __global const field_t * restrict pressure,
+    __global const field_t * restrict xvel0,
+    __global const field_t * restrict yvel0,
+    __global volatile double * partial_sums,
+    __global volatile int * group_counter,
+    __global double * restrict summary)
+{   
 
-#else
+    double sums[FIELD_SUMMARY_VALUES] = {0.0, 0.0, 0.0, 0.0, 0.0};
 
-        //CPU reduction
-        barrier(CLK_LOCAL_MEM_FENCE);
+    __local double sum_local[FIELD_SUMMARY_VALUES*WORKGROUP_SIZE];
+    __local int last_group;
 
-        if (localid==0) {
-            for (int index = 1; index < WORKGROUP_SIZE; index++ ) {
-                vol_sum_local[localid] += vol_sum_local[index];
-                mass_sum_local[localid] += mass_sum_local[index];
-                ie_sum_local[localid] += ie_sum_local[index];
-                ke_sum_local[localid] += ke_sum_local[index];
-                press_sum_local[localid] += press_sum_local[index];
-            }
-        }
+    int member = get_global_id(2);
+    int k = get_global_id(1) + member*MEMBER_ROWS;
+    int j = get_global_id(0);
 
-#endif
+    int localid = get_local_id(1)*get_local_size(0)+get_local_id(0);
+    int num_groups = get_num_groups(0)*get_num_groups(1);
 
+    partial_sums += FIELD_SUMMARY_VALUES*num_groups*member;
+    group_counter += member;
+    summary += FIELD_SUMMARY_VALUES*member;
+
+    if ( (j>=2) && (j<=XMAXPLUSONE) && (get_global_id(1)>=2) && (get_global_id(1)<=MEMBER_YMAX+1) ) {
+        field_summary_cell(j, k, volume, density0, energy0, pressure, xvel0, yvel0, sums);
+    }
+
+    field_summary_workgroup_sum(sums, sum_local);
 
     if (localid==0) {
 
-        int write_loc = get_group_id(1)*get_num_groups(0) + get_group_id(0);
-        vol_tmp_array[write_loc] = vol_sum_local[0];
-        mass_tmp_array[write_loc] = mass_sum_local[0];
-        ie_tmp_array[write_loc] = ie_sum_local[0]; 
-        ke_tmp_array[write_loc] = ke_sum_local[0];
-        press_tmp_array[write_loc] = press_sum_local[0];
+        int write_loc = FIELD_SUMMARY_VALUES*(get_group_id(1)*get_num_groups(0) + get_group_id(0));
+
+        for (int v = 0; v < FIELD_SUMMARY_VALUES; v++) {
+            partial_sums[write_loc + v] = sums[v];
+        }
+
+        write_mem_fence(CLK_GLOBAL_MEM_FENCE);
+        last_group = (atomic_inc(group_counter) == num_groups-1);
     }
 
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (last_group) {
+        read_mem_fence(CLK_GLOBAL_MEM_FENCE);
+
+        field_summary_partials_sum(partial_sums, num_groups, localid, sums);
+
+        field_summary_workgroup_sum(sums, sum_local);
+
+        if (localid==0) {
+            for (int v = 0; v < FIELD_SUMMARY_VALUES; v++) {
+                summary[v] = sums[v];
+            }
+            group_counter[0] = 0;
+        }
+    }
 }
@@ -24,16 +24,17 @@
 #include "ocl_knls.h"
 
 __kernel void flux_calc_ocl_kernel(
-    const double dt,
-    __global const double * restrict xarea,
-    __global const double * restrict xvel0,
-    __global const double * restrict xvel1,
-    __global double * restrict vol_flux_x,
-    __global const double * restrict yarea,
-    __global const double * restrict yvel0,
-    __global const double * restrict yvel1,
-    __global double * restrict vol_flux_y)
+    __global const double * restrict dt_value,
+    __global const field_t * restrict xarea,
+    __global const field_t * restrict xvel0,
+    __global const field_t * restrict xvel1,
+    __global field_t * restrict vol_flux_x,
+    __global const field_t * restrict yarea,
+    __global const field_t * restrict yvel0,
+    __global const field_t * restrict yvel1,
+    __global field_t * restrict vol_flux_y)
 {
+    const double dt = MEMBER_DT(dt_value, get_global_id(1));
     int k = get_global_id(1);
     int j = get_global_id(0);
 
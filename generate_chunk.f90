@@ -27,22 +27,26 @@ SUBROUTINE generate_chunk(chunk)
 
   INTEGER         :: chunk
 
-  INTEGER         :: state
-  REAL(KIND=8), DIMENSION(number_of_states) :: state_density,state_energy,state_xvel,state_yvel
-  REAL(KIND=8), DIMENSION(number_of_states) :: state_xmin,state_xmax,state_ymin,state_ymax,state_radius
-  INTEGER,      DIMENSION(number_of_states) :: state_geometry
+  INTEGER         :: state,member,s
+  REAL(KIND=8), DIMENSION(number_of_states*number_of_members) :: state_density,state_energy,state_xvel,state_yvel
+  REAL(KIND=8), DIMENSION(number_of_states*number_of_members) :: state_xmin,state_xmax,state_ymin,state_ymax,state_radius
+  INTEGER,      DIMENSION(number_of_states*number_of_members) :: state_geometry
 
-  DO state=1,number_of_states 
-   state_density(state)=states(state)%density
-   state_energy(state)=states(state)%energy
-   state_xvel(state)=states(state)%xvel
-   state_yvel(state)=states(state)%yvel
-   state_xmin(state)=states(state)%xmin
-   state_xmax(state)=states(state)%xmax
-   state_ymin(state)=states(state)%ymin
-   state_ymax(state)=states(state)%ymax
-   state_radius(state)=states(state)%radius
-   state_geometry(state)=states(state)%geometry
+  ! The states of each ensemble member follow those of the one before
+  DO member=1,number_of_members
+    DO state=1,number_of_states 
+     s=(member-1)*number_of_states+state
+     state_density(s)=member_states(state,member)%density
+     state_energy(s)=member_states(state,member)%energy
+     state_xvel(s)=member_states(state,member)%xvel
+     state_yvel(s)=member_states(state,member)%yvel
+     state_xmin(s)=member_states(state,member)%xmin
+     state_xmax(s)=member_states(state,member)%xmax
+     state_ymin(s)=member_states(state,member)%ymin
+     state_ymax(s)=member_states(state,member)%ymax
+     state_radius(s)=member_states(state,member)%radius
+     state_geometry(s)=member_states(state,member)%geometry
+    ENDDO
   ENDDO
 
   CALL generate_chunk_kernel_ocl(chunks(chunk)%field%x_min,             &
@@ -26,14 +26,14 @@
 #include "ocl_knls.h"
 
 __kernel void generate_chunk_ocl_kernel(
-        __global const double * restrict vertexx,    
-        __global const double * restrict vertexy,    
-        __global const double * restrict cellx,
-        __global const double * restrict celly,
-        __global double * restrict density0,
-        __global double * restrict energy0,
-        __global double * restrict xvel0,
-        __global double * restrict yvel0,
+        __global const field_t * restrict vertexx,    
+        __global const field_t * restrict vertexy,    
+        __global const field_t * restrict cellx,
+        __global const field_t * restrict celly,
+        __global field_t * restrict density0,
+        __global field_t * restrict energy0,
+        __global field_t * restrict xvel0,
+        __global field_t * restrict yvel0,
         const int number_of_states,
         __global const double * restrict state_density,
         __global const double * restrict state_energy,
@@ -57,6 +57,19 @@ __kernel void generate_chunk_ocl_kernel(
 
         int highest_state = 1;
 
+        // the states of each ensemble member follow on from the last member's
+        const int member_states = MEMBER_OF(ARRAY1D(k, YMIN-2))*number_of_states;
+        state_density  += member_states;
+        state_energy   += member_states;
+        state_xvel     += member_states;
+        state_yvel     += member_states;
+        state_xmin     += member_states;
+        state_xmax     += member_states;
+        state_ymin     += member_states;
+        state_ymax     += member_states;
+        state_radius   += member_states;
+        state_geometry += member_states;
+
         for (int state = 1; state <= number_of_states; state++) {
             if(state_geometry[ARRAY1D(state,1)] == g_rect) {
               if(vertexx[ARRAY1D(j,-1)] >= state_xmin[ARRAY1D(state,1)] && vertexx[ARRAY1D(j,-1)] < state_xmax[ARRAY1D(state,1)]) {
@@ -65,7 +78,7 @@ __kernel void generate_chunk_ocl_kernel(
                 }
               }
             } else if(state_geometry[ARRAY1D(state,1)] == g_circ ) {
-              radius=sqrt(cellx[ARRAY1D(j,-1)]*cellx[ARRAY1D(j,-1)]+celly[ARRAY1D(k,-1)]*celly[ARRAY1D(k,-1)]);
+              radius=sqrt((double)cellx[ARRAY1D(j,-1)]*cellx[ARRAY1D(j,-1)]+celly[ARRAY1D(k,-1)]*celly[ARRAY1D(k,-1)]);
               if(radius <= state_radius[ARRAY1D(state,1)]){
                     highest_state = state;
               }
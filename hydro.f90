@@ -39,6 +39,9 @@ SUBROUTINE hydro
   REAL(KIND=8)    :: step_time,step_grind
   REAL(KIND=8)    :: first_step,second_step
 
+  LOGICAL         :: replayed
+  INTEGER         :: parity
+
   CALL zero_ocl_profiling_timers()
   timerstart = timer()
 
@@ -48,23 +51,47 @@ SUBROUTINE hydro
 
     step = step + 1
 
-    CALL timestep()
+    IF(use_OpenCL_kernels.AND.OpenCL_event_profile) CALL ocl_profile_step(step)
+
+    ! Once a step of this sweep order has been recorded it is replayed
+    ! instead of walking the drivers
+    replayed=.FALSE.
+    IF(use_OpenCL_kernels.AND.OpenCL_step_replay) CALL timestep_replay(replayed)
+
+    IF(.NOT.replayed) THEN
+
+      parity=0
+      IF(advect_x) parity=1
+      IF(use_OpenCL_kernels.AND.OpenCL_step_replay) CALL ocl_record_step_begin(parity,dtold,dtrise,dtmax)
+
+      CALL timestep()
     
-    CALL PdV(.TRUE.)
+      CALL PdV(.TRUE.)
+
+      CALL accelerate()
 
-    CALL accelerate()
+      CALL PdV(.FALSE.)
 
-    CALL PdV(.FALSE.)
+      CALL flux_calc()
 
-    CALL flux_calc()
+      CALL advection()
 
-    CALL advection()
+      CALL reset_field()
 
-    CALL reset_field()
+      IF(use_OpenCL_kernels.AND.OpenCL_step_replay) CALL ocl_record_step_end(parity)
+
+    ENDIF
 
     advect_x = .NOT. advect_x
   
-    time = time + dt
+    IF(number_of_members.GT.1) THEN
+      CALL timestep_members_advance()
+    ELSE
+      time = time + dt
+    ENDIF
+
+    ! An async summary from an earlier step has arrived behind this step's dt
+    IF(summary_pending) CALL field_summary_collect()
 
     IF(summary_frequency.NE.0) THEN
       IF(MOD(step, summary_frequency).EQ.0) CALL field_summary()
@@ -72,6 +99,9 @@ SUBROUTINE hydro
     IF(visit_frequency.NE.0) THEN
       IF(MOD(step, visit_frequency).EQ.0) CALL visit()
     ENDIF
+    IF(checkpoint_frequency.NE.0) THEN
+      IF(MOD(step, checkpoint_frequency).EQ.0) CALL checkpoint()
+    ENDIF
 
     ! Sometimes there can be a significant start up cost that appears in the first step.
     ! Sometimes it is due to the number of MPI tasks, or OpenCL kernel compilation.
@@ -86,6 +116,11 @@ SUBROUTINE hydro
       CALL field_summary()
       IF(visit_frequency.NE.0) CALL visit()
 
+      ! The last binary dump may still be being written
+      IF(use_OpenCL_kernels.AND.OpenCL_binary_vis) CALL ocl_wait_vis_writer()
+      IF(use_OpenCL_kernels.AND.checkpoint_frequency.NE.0) CALL ocl_wait_checkpoint_writer()
+      IF(use_OpenCL_kernels.AND.OpenCL_event_profile) CALL ocl_finish_event_profile()
+
       wall_clock=timer() - timerstart
       IF ( parallel%boss ) THEN
         WRITE(g_out,*)
@@ -113,7 +148,7 @@ SUBROUTINE hydro
       step_clock=timer()-step_time
       WRITE(g_out,*)"Wall clock ",wall_clock
       !WRITE(0    ,*)"Wall clock ",wall_clock
-      cells = grid%x_cells * grid%y_cells
+      cells = grid%x_cells * grid%y_cells * number_of_members
       rstep = step
       grind_time   = wall_clock/(rstep * cells)
       step_grind   = step_clock/cells
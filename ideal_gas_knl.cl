@@ -25,24 +25,24 @@
 #include "ocl_knls.h"
 
 __kernel void ideal_gas_ocl_kernel(
-    __global const double * restrict density,
-    __global const double * restrict energy,
-    __global double * restrict pressure,
-    __global double * restrict soundspeed)
+    __global const field_t * restrict density,
+    __global const field_t * restrict energy,
+    __global field_t * restrict pressure,
+    __global field_t * restrict soundspeed)
 {
 
     int k = get_global_id(1);
     int j = get_global_id(0);
 
-    double sound_speed_squared,v,pressurebyenergy,pressurebyvolume;
+    calc_t sound_speed_squared,v,pressurebyenergy,pressurebyvolume;
 
-    if ( (j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE) ) {
+    if ( IN_RANGE( (j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE) ) ) {
 
-        v = 1.0/density[ARRAYXY(j,k,XMAXPLUSFOUR)];
+        v = CALC(1.0)/density[ARRAYXY(j,k,XMAXPLUSFOUR)];
 
-        pressure[ARRAYXY(j,k,XMAXPLUSFOUR)]=(1.4-1.0)*density[ARRAYXY(j,k,XMAXPLUSFOUR)]*energy[ARRAYXY(j,k,XMAXPLUSFOUR)];
+        pressure[ARRAYXY(j,k,XMAXPLUSFOUR)]=CALC(1.4-1.0)*density[ARRAYXY(j,k,XMAXPLUSFOUR)]*energy[ARRAYXY(j,k,XMAXPLUSFOUR)];
 
-        pressurebyenergy=(1.4-1.0)*density[ARRAYXY(j,k,XMAXPLUSFOUR)];
+        pressurebyenergy=CALC(1.4-1.0)*density[ARRAYXY(j,k,XMAXPLUSFOUR)];
 
         pressurebyvolume=-density[ARRAYXY(j,k,XMAXPLUSFOUR)]*pressure[ARRAYXY(j,k,XMAXPLUSFOUR)];
 
@@ -135,6 +135,7 @@ SUBROUTINE initialise
   CALL clover_barrier
 
   step=0
+  summary_pending=.FALSE.
 
   CALL start
 
@@ -25,9 +25,9 @@
 
 __kernel void initialise_chunk_cell_x_ocl_kernel(
     const double dx,
-    __global const double * restrict vertexx,
-    __global double * restrict cellx,
-    __global double * restrict celldx)
+    __global const field_t * restrict vertexx,
+    __global field_t * restrict cellx,
+    __global field_t * restrict celldx)
 {
 
     int j = get_global_id(0)-2;
@@ -44,9 +44,9 @@ __kernel void initialise_chunk_cell_x_ocl_kernel(
 
 __kernel void initialise_chunk_cell_y_ocl_kernel(
     const double dy,
-    __global const double * restrict vertexy,
-    __global double * restrict celly,
-    __global double * restrict celldy)
+    __global const field_t * restrict vertexy,
+    __global field_t * restrict celly,
+    __global field_t * restrict celldy)
 {
 
     int k = get_global_id(0)-2;
@@ -63,8 +63,8 @@ __kernel void initialise_chunk_cell_y_ocl_kernel(
 __kernel void initialise_chunk_vertex_x_ocl_kernel(
     const double xmin,
     const double dx,
-    __global double * restrict vertexx,
-    __global double * restrict vertexdx)
+    __global field_t * restrict vertexx,
+    __global field_t * restrict vertexdx)
 {
 
     int j = get_global_id(0)-2;
@@ -81,15 +81,16 @@ __kernel void initialise_chunk_vertex_x_ocl_kernel(
 __kernel void initialise_chunk_vertex_y_ocl_kernel(
     const double ymin,
     const double dy,
-    __global double * restrict vertexy,
-    __global double * restrict vertexdy)
+    __global field_t * restrict vertexy,
+    __global field_t * restrict vertexdy)
 {  
 
     int k = get_global_id(0)-2;
 
     if (k<=YMAX+3) {
 
-        vertexy[ARRAY1D(k, YMIN-2)] = ymin + dy * (k-YMIN);
+        // each ensemble member has its own coordinates from ymin
+        vertexy[ARRAY1D(k, YMIN-2)] = ymin + dy * (MEMBER_ROW(ARRAY1D(k, YMIN-2))-2);
 
         vertexdy[ARRAY1D(k, YMIN-2)] = dy;
 
@@ -100,11 +101,11 @@ __kernel void initialise_chunk_vertex_y_ocl_kernel(
 __kernel void initialise_chunk_volume_area_ocl_kernel(
     const double dx,
     const double dy,
-    __global double * restrict volume,
-    __global const double * restrict celldx,
-    __global const double * restrict celldy,
-    __global double * restrict xarea,
-    __global double * restrict yarea)
+    __global field_t * restrict volume,
+    __global const field_t * restrict celldx,
+    __global const field_t * restrict celldy,
+    __global field_t * restrict xarea,
+    __global field_t * restrict yarea)
 {   
     int k = get_global_id(1);
     int j = get_global_id(0);
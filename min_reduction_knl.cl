@@ -133,3 +133,110 @@ __kernel void reduction_minimum_last_ocl_kernel(
 
     if (lj==0) min_val_output[wg_id_x] = min_val_local[0];
 }
+
+/*
+ *  Reduces the value held by each work item to work item 0, with sub-group
+ *  operations where the device has them and in local memory otherwise
+ */
+double workgroup_minimum(double min_value, __local double * restrict min_val_local)
+{
+    int lj = get_local_id(0);
+
+#if defined(SUBGROUP_REDUCTION)
+
+    min_value = sub_group_reduce_min(min_value);
+
+    if (get_sub_group_local_id() == 0) min_val_local[get_sub_group_id()] = min_value;
+
+    barrier(CLK_LOCAL_MEM_FENCE); 
+
+    if (lj==0) {
+        for (uint index = 1; index < get_num_sub_groups(); index++) {
+            min_value = fmin( min_value, min_val_local[index] );
+        }
+    }
+
+#elif defined(GPU_REDUCTION)
+
+    min_val_local[lj] = min_value;
+
+    barrier(CLK_LOCAL_MEM_FENCE); 
+
+    for (int limit = WORKGROUP_SIZE_DIVTWO; limit > 0; limit >>= 1 ) {
+        if (lj < limit) {
+            min_val_local[lj] = fmin( min_val_local[lj], min_val_local[lj+limit] );
+        }
+
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    min_value = min_val_local[0];
+
+#else
+
+    min_val_local[lj] = min_value;
+
+    barrier(CLK_LOCAL_MEM_FENCE); 
+
+    if (lj==0) {
+        for (int index = 1; index < WORKGROUP_SIZE; index++) {
+            min_value = fmin( min_value, min_val_local[index] );
+        }
+    }
+
+#endif
+
+    return min_value;
+}
+
+/*
+ *  Single launch minimum. Each work group reduces a strided share of the input
+ *  and stores a partial result, the last group to finish (found through the
+ *  counter for this slot) reduces the partials and resets the counter.
+ */
+__kernel void reduction_minimum_single_ocl_kernel(
+	__global const double * restrict min_val_input,
+    const int total_num_elements,
+    const int slot,
+	__global volatile double * partial_vals,
+	__global volatile int * group_counters,
+	__global double * restrict min_val_output)
+{
+    __local double min_val_local[WORKGROUP_SIZE];
+    __local int last_group;
+
+    int lj = get_local_id(0);
+    int num_groups = get_num_groups(0);
+    double min_value = 100000; 
+
+    for (int i = get_global_id(0); i < total_num_elements; i += get_global_size(0)) {
+        min_value = fmin( min_value, min_val_input[i] ); 
+    }
+
+    min_value = workgroup_minimum(min_value, min_val_local);
+
+    if (lj==0) {
+        partial_vals[slot*num_groups + get_group_id(0)] = min_value;
+        write_mem_fence(CLK_GLOBAL_MEM_FENCE);
+        last_group = (atomic_inc(&group_counters[slot]) == num_groups-1);
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE); 
+
+    if (last_group) {
+        read_mem_fence(CLK_GLOBAL_MEM_FENCE);
+
+        min_value = 100000; 
+
+        for (int i = lj; i < num_groups; i += WORKGROUP_SIZE) {
+            min_value = fmin( min_value, partial_vals[slot*num_groups + i] ); 
+        }
+
+        min_value = workgroup_minimum(min_value, min_val_local);
+
+        if (lj==0) {
+            min_val_output[0] = min_value;
+            group_counters[slot] = 0;
+        }
+    }
+}
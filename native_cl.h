@@ -0,0 +1,609 @@
+/*Crown Copyright 2012 AWE.
+*
+* This file is part of CloverLeaf.
+*
+* CloverLeaf is free software: you can redistribute it and/or modify it under
+* the terms of the GNU General Public License as published by the
+* Free Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* CloverLeaf is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* CloverLeaf. If not, see http://www.gnu.org/licenses/. */
+
+/**
+ *  @brief Native host stand-in for the OpenCL C++ bindings.
+ *  @details A CLOVER_NATIVE build includes this in place of CL/cl.hpp. It
+ *  carries the part of the cl:: interface CloverCL uses, for one CPU device
+ *  whose buffers are host memory and whose queues run each command as it is
+ *  enqueued. A kernel is found by name among the kernel sources compiled into
+ *  native_kernels.C and runs there as OpenMP loops, so nothing is compiled at
+ *  run time and no OpenCL library is needed. Errors throw cl::Error with the
+ *  OpenCL error codes, as the bindings do with __CL_ENABLE_EXCEPTIONS.
+ */
+
+#ifndef CLOVER_NATIVE_CL_H_
+#define CLOVER_NATIVE_CL_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+
+typedef int32_t cl_int;
+typedef uint32_t cl_uint;
+typedef int64_t cl_long;
+typedef uint64_t cl_ulong;
+typedef float cl_float;
+typedef double cl_double;
+typedef cl_uint cl_bool;
+typedef cl_ulong cl_bitfield;
+typedef cl_bitfield cl_device_type;
+typedef cl_bitfield cl_mem_flags;
+typedef cl_bitfield cl_map_flags;
+typedef cl_bitfield cl_command_queue_properties;
+typedef cl_uint cl_platform_info;
+typedef cl_uint cl_device_info;
+typedef cl_uint cl_context_info;
+typedef cl_uint cl_mem_info;
+typedef cl_uint cl_program_info;
+typedef cl_uint cl_program_build_info;
+typedef cl_uint cl_kernel_info;
+typedef cl_uint cl_kernel_work_group_info;
+typedef cl_uint cl_event_info;
+typedef cl_uint cl_profiling_info;
+typedef cl_uint cl_buffer_create_type;
+typedef intptr_t cl_context_properties;
+
+typedef struct _cl_platform_id* cl_platform_id;
+typedef struct _cl_device_id* cl_device_id;
+typedef struct _cl_context* cl_context;
+typedef struct _cl_command_queue* cl_command_queue;
+typedef struct _cl_mem* cl_mem;
+typedef struct _cl_program* cl_program;
+typedef struct _cl_kernel* cl_kernel;
+typedef struct _cl_event* cl_event;
+
+typedef struct {
+    ::size_t origin;
+    ::size_t size;
+} cl_buffer_region;
+
+/* A command's timestamps, all taken on the host as it runs */
+struct _cl_event
+{
+    cl_ulong queued, submit, start, end;
+    std::shared_ptr<_cl_command_queue> queue;
+};
+
+#define CL_API_CALL
+
+#define CL_FALSE 0
+#define CL_TRUE 1
+
+#define CL_SUCCESS 0
+#define CL_DEVICE_NOT_FOUND -1
+#define CL_DEVICE_NOT_AVAILABLE -2
+#define CL_COMPILER_NOT_AVAILABLE -3
+#define CL_MEM_OBJECT_ALLOCATION_FAILURE -4
+#define CL_OUT_OF_RESOURCES -5
+#define CL_OUT_OF_HOST_MEMORY -6
+#define CL_PROFILING_INFO_NOT_AVAILABLE -7
+#define CL_MEM_COPY_OVERLAP -8
+#define CL_IMAGE_FORMAT_MISMATCH -9
+#define CL_IMAGE_FORMAT_NOT_SUPPORTED -10
+#define CL_BUILD_PROGRAM_FAILURE -11
+#define CL_MAP_FAILURE -12
+#define CL_INVALID_VALUE -30
+#define CL_INVALID_DEVICE_TYPE -31
+#define CL_INVALID_PLATFORM -32
+#define CL_INVALID_DEVICE -33
+#define CL_INVALID_CONTEXT -34
+#define CL_INVALID_QUEUE_PROPERTIES -35
+#define CL_INVALID_COMMAND_QUEUE -36
+#define CL_INVALID_HOST_PTR -37
+#define CL_INVALID_MEM_OBJECT -38
+#define CL_INVALID_IMAGE_FORMAT_DESCRIPTOR -39
+#define CL_INVALID_IMAGE_SIZE -40
+#define CL_INVALID_SAMPLER -41
+#define CL_INVALID_BINARY -42
+#define CL_INVALID_BUILD_OPTIONS -43
+#define CL_INVALID_PROGRAM -44
+#define CL_INVALID_PROGRAM_EXECUTABLE -45
+#define CL_INVALID_KERNEL_NAME -46
+#define CL_INVALID_KERNEL_DEFINITION -47
+#define CL_INVALID_KERNEL -48
+#define CL_INVALID_ARG_INDEX -49
+#define CL_INVALID_ARG_VALUE -50
+#define CL_INVALID_ARG_SIZE -51
+#define CL_INVALID_KERNEL_ARGS -52
+#define CL_INVALID_WORK_DIMENSION -53
+#define CL_INVALID_WORK_GROUP_SIZE -54
+#define CL_INVALID_WORK_ITEM_SIZE -55
+#define CL_INVALID_GLOBAL_OFFSET -56
+#define CL_INVALID_EVENT_WAIT_LIST -57
+#define CL_INVALID_EVENT -58
+#define CL_INVALID_OPERATION -59
+#define CL_INVALID_GL_OBJECT -60
+#define CL_INVALID_BUFFER_SIZE -61
+#define CL_INVALID_MIP_LEVEL -62
+#define CL_INVALID_GLOBAL_WORK_SIZE -63
+#define CL_INVALID_PROPERTY -64
+
+#define CL_PLATFORM_PROFILE 0x0900
+#define CL_PLATFORM_VERSION 0x0901
+#define CL_PLATFORM_NAME 0x0902
+#define CL_PLATFORM_VENDOR 0x0903
+#define CL_PLATFORM_EXTENSIONS 0x0904
+
+#define CL_DEVICE_TYPE_DEFAULT (1 << 0)
+#define CL_DEVICE_TYPE_CPU (1 << 1)
+#define CL_DEVICE_TYPE_GPU (1 << 2)
+#define CL_DEVICE_TYPE_ACCELERATOR (1 << 3)
+#define CL_DEVICE_TYPE_ALL 0xFFFFFFFF
+
+#define CL_DEVICE_TYPE 0x1000
+#define CL_DEVICE_MAX_COMPUTE_UNITS 0x1002
+#define CL_DEVICE_MAX_WORK_GROUP_SIZE 0x1004
+#define CL_DEVICE_MAX_WORK_ITEM_SIZES 0x1005
+#define CL_DEVICE_MAX_CLOCK_FREQUENCY 0x100C
+#define CL_DEVICE_MAX_MEM_ALLOC_SIZE 0x1010
+#define CL_DEVICE_MEM_BASE_ADDR_ALIGN 0x1019
+#define CL_DEVICE_GLOBAL_MEM_SIZE 0x101F
+#define CL_DEVICE_LOCAL_MEM_SIZE 0x1023
+#define CL_DEVICE_NAME 0x102B
+#define CL_DEVICE_VENDOR 0x102C
+#define CL_DRIVER_VERSION 0x102D
+#define CL_DEVICE_VERSION 0x102F
+#define CL_DEVICE_EXTENSIONS 0x1030
+#define CL_DEVICE_OPENCL_C_VERSION 0x103D
+
+#define CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE (1 << 0)
+#define CL_QUEUE_PROFILING_ENABLE (1 << 1)
+
+#define CL_CONTEXT_DEVICES 0x1081
+#define CL_CONTEXT_PLATFORM 0x1084
+
+#define CL_MEM_READ_WRITE (1 << 0)
+#define CL_MEM_WRITE_ONLY (1 << 1)
+#define CL_MEM_READ_ONLY (1 << 2)
+#define CL_MEM_USE_HOST_PTR (1 << 3)
+#define CL_MEM_ALLOC_HOST_PTR (1 << 4)
+#define CL_MEM_COPY_HOST_PTR (1 << 5)
+
+#define CL_MAP_READ (1 << 0)
+#define CL_MAP_WRITE (1 << 1)
+
+#define CL_MEM_SIZE 0x1102
+#define CL_BUFFER_CREATE_TYPE_REGION 0x1220
+
+#define CL_PROGRAM_BINARY_SIZES 0x1165
+#define CL_PROGRAM_BINARIES 0x1166
+#define CL_PROGRAM_BUILD_LOG 0x1183
+
+#define CL_KERNEL_FUNCTION_NAME 0x1190
+#define CL_KERNEL_WORK_GROUP_SIZE 0x11B0
+#define CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE 0x11B3
+
+#define CL_EVENT_COMMAND_QUEUE 0x11D0
+#define CL_EVENT_COMMAND_EXECUTION_STATUS 0x11D3
+#define CL_COMPLETE 0x0
+
+#define CL_PROFILING_COMMAND_QUEUED 0x1280
+#define CL_PROFILING_COMMAND_SUBMIT 0x1281
+#define CL_PROFILING_COMMAND_START 0x1282
+#define CL_PROFILING_COMMAND_END 0x1283
+
+/* No platform extensions, so the step replay finds no command buffers */
+inline void* clGetExtensionFunctionAddressForPlatform(cl_platform_id, const char*) { return NULL; }
+
+namespace cl {
+
+class Device;
+class CommandQueue;
+class Buffer;
+class Program;
+class Kernel;
+
+class Error
+{
+    public:
+        Error(cl_int err, const char* errStr = NULL) : err_(err), errStr_(errStr) {}
+
+        cl_int err() const { return err_; }
+        const char* what() const { return errStr_ != NULL ? errStr_ : "empty"; }
+
+    private:
+        cl_int err_;
+        const char* errStr_;
+};
+
+template <int N>
+struct size_t
+{
+    ::size_t data_[N];
+
+    ::size_t& operator[](int index) { return data_[index]; }
+    const ::size_t& operator[](int index) const { return data_[index]; }
+};
+
+class NDRange
+{
+    public:
+        NDRange() : dimensions_(0) { sizes_[0] = sizes_[1] = sizes_[2] = 0; }
+        NDRange(::size_t size0) : dimensions_(1) { sizes_[0] = size0; sizes_[1] = sizes_[2] = 1; }
+        NDRange(::size_t size0, ::size_t size1) : dimensions_(2)
+            { sizes_[0] = size0; sizes_[1] = size1; sizes_[2] = 1; }
+        NDRange(::size_t size0, ::size_t size1, ::size_t size2) : dimensions_(3)
+            { sizes_[0] = size0; sizes_[1] = size1; sizes_[2] = size2; }
+
+        ::size_t dimensions() const { return dimensions_; }
+        operator const ::size_t*() const { return sizes_; }
+
+    private:
+        ::size_t sizes_[3];
+        cl_uint dimensions_;
+};
+
+static const NDRange NullRange;
+
+struct LocalSpaceArg
+{
+    ::size_t size_;
+};
+
+inline LocalSpaceArg Local(::size_t size)
+{
+    LocalSpaceArg local = { size };
+    return local;
+}
+
+inline LocalSpaceArg __local(::size_t size) { return Local(size); }
+
+namespace native {
+
+/*
+ * The -D values of a program's build options the kernels read, fixed when
+ * the program is built as they would be compiled into an OpenCL binary
+ */
+struct Defines
+{
+    int xmin, xmax, ymin, ymax;
+    int workgroup_size;
+    int calcdt_wg_x, calcdt_wg_y;
+    int advec_wg_x, advec_wg_y;
+    int advmom_wg_x, advmom_wg_y;
+    int ensemble_members, member_ymax;
+    int external_faces;
+};
+
+/* A kernel argument as its bytes; a buffer is held as its data pointer */
+struct KernelArg
+{
+    std::shared_ptr<_cl_mem> mem;
+    ::size_t size;
+    unsigned char value[16];
+};
+
+/* Everything a launcher is given for one enqueueNDRangeKernel */
+struct Launch
+{
+    const char* name;
+    const Defines* defines;
+    const KernelArg* args;
+    ::size_t num_args;
+    cl_uint dimensions;
+    ::size_t offset[3];
+    ::size_t global[3];
+    ::size_t local[3];
+};
+
+typedef void (*Launcher)(Launch const& launch);
+
+/* The launcher of a kernel in native_kernels.C, or NULL if there is none */
+Launcher findLauncher(std::string const& name);
+
+template <cl_uint name> struct param_traits;
+
+#define CLOVER_NATIVE_PARAM(name, type) template <> struct param_traits<name> { typedef type param_type; };
+
+CLOVER_NATIVE_PARAM(CL_PLATFORM_VENDOR, std::string)
+CLOVER_NATIVE_PARAM(CL_PLATFORM_NAME, std::string)
+CLOVER_NATIVE_PARAM(CL_PLATFORM_VERSION, std::string)
+CLOVER_NATIVE_PARAM(CL_DEVICE_TYPE, cl_device_type)
+CLOVER_NATIVE_PARAM(CL_DEVICE_MAX_COMPUTE_UNITS, cl_uint)
+CLOVER_NATIVE_PARAM(CL_DEVICE_MAX_WORK_GROUP_SIZE, ::size_t)
+CLOVER_NATIVE_PARAM(CL_DEVICE_MAX_WORK_ITEM_SIZES, std::vector< ::size_t>)
+CLOVER_NATIVE_PARAM(CL_DEVICE_MAX_CLOCK_FREQUENCY, cl_uint)
+CLOVER_NATIVE_PARAM(CL_DEVICE_MAX_MEM_ALLOC_SIZE, cl_ulong)
+CLOVER_NATIVE_PARAM(CL_DEVICE_MEM_BASE_ADDR_ALIGN, cl_uint)
+CLOVER_NATIVE_PARAM(CL_DEVICE_GLOBAL_MEM_SIZE, cl_ulong)
+CLOVER_NATIVE_PARAM(CL_DEVICE_LOCAL_MEM_SIZE, cl_ulong)
+CLOVER_NATIVE_PARAM(CL_DEVICE_NAME, std::string)
+CLOVER_NATIVE_PARAM(CL_DEVICE_VENDOR, std::string)
+CLOVER_NATIVE_PARAM(CL_DRIVER_VERSION, std::string)
+CLOVER_NATIVE_PARAM(CL_DEVICE_VERSION, std::string)
+CLOVER_NATIVE_PARAM(CL_DEVICE_EXTENSIONS, std::string)
+CLOVER_NATIVE_PARAM(CL_DEVICE_OPENCL_C_VERSION, std::string)
+CLOVER_NATIVE_PARAM(CL_CONTEXT_DEVICES, std::vector<Device>)
+CLOVER_NATIVE_PARAM(CL_MEM_SIZE, ::size_t)
+CLOVER_NATIVE_PARAM(CL_PROGRAM_BINARY_SIZES, std::vector< ::size_t>)
+CLOVER_NATIVE_PARAM(CL_PROGRAM_BINARIES, std::vector<char*>)
+CLOVER_NATIVE_PARAM(CL_PROGRAM_BUILD_LOG, std::string)
+CLOVER_NATIVE_PARAM(CL_KERNEL_FUNCTION_NAME, std::string)
+CLOVER_NATIVE_PARAM(CL_KERNEL_WORK_GROUP_SIZE, ::size_t)
+CLOVER_NATIVE_PARAM(CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, ::size_t)
+CLOVER_NATIVE_PARAM(CL_EVENT_COMMAND_QUEUE, CommandQueue)
+CLOVER_NATIVE_PARAM(CL_EVENT_COMMAND_EXECUTION_STATUS, cl_int)
+CLOVER_NATIVE_PARAM(CL_PROFILING_COMMAND_QUEUED, cl_ulong)
+CLOVER_NATIVE_PARAM(CL_PROFILING_COMMAND_SUBMIT, cl_ulong)
+CLOVER_NATIVE_PARAM(CL_PROFILING_COMMAND_START, cl_ulong)
+CLOVER_NATIVE_PARAM(CL_PROFILING_COMMAND_END, cl_ulong)
+
+#undef CLOVER_NATIVE_PARAM
+
+/* The numeric device properties, each widened to cl_ulong */
+cl_ulong deviceValue(cl_device_info name);
+
+inline void setError(cl_int* err)
+{
+    if (err != NULL) *err = CL_SUCCESS;
+}
+
+} // namespace native
+
+/*
+ * The single native device and the platform that holds it
+ */
+class Device
+{
+    public:
+        Device() : object_(NULL) {}
+        explicit Device(cl_device_id device) : object_(device) {}
+
+        cl_int getInfo(cl_device_info name, std::string* param) const;
+        cl_int getInfo(cl_device_info name, std::vector< ::size_t>* param) const;
+
+        template <typename T>
+        cl_int getInfo(cl_device_info name, T* param) const
+        {
+            *param = (T) native::deviceValue(name);
+            return CL_SUCCESS;
+        }
+
+        template <cl_uint name>
+        typename native::param_traits<name>::param_type getInfo(cl_int* err = NULL) const
+        {
+            typename native::param_traits<name>::param_type param;
+            getInfo(name, &param);
+            native::setError(err);
+            return param;
+        }
+
+        cl_device_id operator()() const { return object_; }
+
+    private:
+        cl_device_id object_;
+};
+
+class Platform
+{
+    public:
+        Platform() : object_(NULL) {}
+
+        static cl_int get(std::vector<Platform>* platforms);
+
+        cl_int getInfo(cl_platform_info name, std::string* param) const;
+        cl_int getDevices(cl_device_type type, std::vector<Device>* devices) const;
+
+        cl_platform_id operator()() const { return object_; }
+
+    private:
+        cl_platform_id object_;
+};
+
+class Context
+{
+    public:
+        Context() {}
+        Context(cl_device_type type, cl_context_properties* properties, void* notify, void* data, cl_int* err);
+        Context(std::vector<Device> const& devices, cl_context_properties* properties, void* notify, void* data,
+                cl_int* err);
+
+        template <cl_uint name>
+        typename native::param_traits<name>::param_type getInfo(cl_int* err = NULL) const
+        {
+            native::setError(err);
+            return devices_;
+        }
+
+    private:
+        std::vector<Device> devices_;
+};
+
+class Buffer
+{
+    public:
+        Buffer() {}
+        Buffer(Context const& context, cl_mem_flags flags, ::size_t size, void* host_ptr = NULL, cl_int* err = NULL);
+
+        Buffer createSubBuffer(cl_mem_flags flags, cl_buffer_create_type type, const void* region,
+                               cl_int* err = NULL);
+
+        cl_int getInfo(cl_mem_info name, ::size_t* param) const;
+
+        unsigned char* data() const;
+        cl_mem operator()() const { return object_.get(); }
+
+    private:
+        friend class Kernel;
+        std::shared_ptr<_cl_mem> object_;
+};
+
+class Event
+{
+    public:
+        Event() {}
+
+        cl_int wait() const { return CL_SUCCESS; }
+        static cl_int waitForEvents(std::vector<Event> const& /* events */) { return CL_SUCCESS; }
+
+        template <cl_uint name>
+        typename native::param_traits<name>::param_type getInfo(cl_int* err = NULL) const;
+
+        template <cl_uint name>
+        cl_ulong getProfilingInfo(cl_int* err = NULL) const
+        {
+            native::setError(err);
+
+            switch (name) {
+                case CL_PROFILING_COMMAND_QUEUED: return object_->queued;
+                case CL_PROFILING_COMMAND_SUBMIT: return object_->submit;
+                case CL_PROFILING_COMMAND_START:  return object_->start;
+                default:                          return object_->end;
+            }
+        }
+
+        cl_event operator()() const { return object_.get(); }
+
+    private:
+        friend class CommandQueue;
+        std::shared_ptr<_cl_event> object_;
+};
+
+class Program
+{
+    public:
+        typedef std::vector<std::pair<const char*, ::size_t> > Sources;
+        typedef std::vector<std::pair<const void*, ::size_t> > Binaries;
+
+        Program() {}
+        Program(Context const& context, Sources const& sources, cl_int* err = NULL);
+        Program(Context const& context, std::vector<Device> const& devices, Binaries const& binaries,
+                std::vector<cl_int>* status = NULL, cl_int* err = NULL);
+
+        cl_int build(std::vector<Device> const& devices, const char* options = NULL, void* notify = NULL,
+                     void* data = NULL) const;
+
+        cl_int getInfo(cl_program_info name, std::vector< ::size_t>* param) const;
+        cl_int getInfo(cl_program_info name, std::vector<char*>* param) const;
+        cl_int getBuildInfo(Device const& device, cl_program_build_info name, std::string* param) const;
+
+        cl_program operator()() const { return object_.get(); }
+
+    private:
+        friend class Kernel;
+        std::shared_ptr<_cl_program> object_;
+};
+
+class Kernel
+{
+    public:
+        Kernel() {}
+        Kernel(Program const& program, const char* name, cl_int* err = NULL);
+
+        cl_int setArg(cl_uint index, Buffer const& value);
+        cl_int setArg(cl_uint index, LocalSpaceArg const& value);
+        cl_int setArg(cl_uint index, ::size_t size, const void* value);
+
+        template <typename T>
+        cl_int setArg(cl_uint index, T const& value) { return setArg(index, sizeof(T), &value); }
+
+        cl_int getInfo(cl_kernel_info name, std::string* param) const;
+
+        template <cl_uint name>
+        std::string getInfo(cl_int* err = NULL) const
+        {
+            std::string param;
+            getInfo(name, &param);
+            native::setError(err);
+            return param;
+        }
+
+        cl_int getWorkGroupInfo(Device const& device, cl_kernel_work_group_info name, ::size_t* param) const;
+
+        cl_kernel operator()() const { return object_.get(); }
+
+    private:
+        friend class CommandQueue;
+        std::shared_ptr<_cl_kernel> object_;
+};
+
+/*
+ * Every command has finished when its enqueue returns, so the blocking flags,
+ * event lists, barriers and markers have nothing left to order
+ */
+class CommandQueue
+{
+    public:
+        CommandQueue() {}
+        CommandQueue(Context const& context, Device const& device, cl_command_queue_properties properties = 0,
+                     cl_int* err = NULL);
+
+        cl_int enqueueNDRangeKernel(Kernel const& kernel, NDRange const& offset, NDRange const& global,
+                                    NDRange const& local = NullRange, const std::vector<Event>* events = NULL,
+                                    Event* event = NULL) const;
+
+        cl_int enqueueReadBuffer(Buffer const& buffer, cl_bool blocking, ::size_t offset, ::size_t size, void* ptr,
+                                 const std::vector<Event>* events = NULL, Event* event = NULL) const;
+        cl_int enqueueWriteBuffer(Buffer const& buffer, cl_bool blocking, ::size_t offset, ::size_t size,
+                                  const void* ptr, const std::vector<Event>* events = NULL, Event* event = NULL) const;
+
+        cl_int enqueueReadBufferRect(Buffer const& buffer, cl_bool blocking, size_t<3> const& buffer_offset,
+                                     size_t<3> const& host_offset, size_t<3> const& region,
+                                     ::size_t buffer_row_pitch, ::size_t buffer_slice_pitch,
+                                     ::size_t host_row_pitch, ::size_t host_slice_pitch, void* ptr,
+                                     const std::vector<Event>* events = NULL, Event* event = NULL) const;
+        cl_int enqueueWriteBufferRect(Buffer const& buffer, cl_bool blocking, size_t<3> const& buffer_offset,
+                                      size_t<3> const& host_offset, size_t<3> const& region,
+                                      ::size_t buffer_row_pitch, ::size_t buffer_slice_pitch,
+                                      ::size_t host_row_pitch, ::size_t host_slice_pitch, const void* ptr,
+                                      const std::vector<Event>* events = NULL, Event* event = NULL) const;
+
+        void* enqueueMapBuffer(Buffer const& buffer, cl_bool blocking, cl_map_flags flags, ::size_t offset,
+                               ::size_t size, const std::vector<Event>* events = NULL, Event* event = NULL,
+                               cl_int* err = NULL) const;
+        cl_int enqueueUnmapMemObject(Buffer const& buffer, void* mapped_ptr, const std::vector<Event>* events = NULL,
+                                     Event* event = NULL) const;
+
+        cl_int enqueueMarker(Event* event = NULL) const;
+        cl_int enqueueBarrier() const { return CL_SUCCESS; }
+        cl_int enqueueWaitForEvents(std::vector<Event> const& /* events */) const { return CL_SUCCESS; }
+
+        cl_int flush() const { return CL_SUCCESS; }
+        cl_int finish() const { return CL_SUCCESS; }
+
+        cl_command_queue operator()() const { return object_.get(); }
+
+    private:
+        friend class Event;
+        explicit CommandQueue(std::shared_ptr<_cl_command_queue> const& object) : object_(object) {}
+
+        void recordEvent(Event* event, cl_ulong queued) const;
+
+        std::shared_ptr<_cl_command_queue> object_;
+};
+
+template <>
+inline CommandQueue Event::getInfo<CL_EVENT_COMMAND_QUEUE>(cl_int* err) const
+{
+    native::setError(err);
+    return CommandQueue(object_->queue);
+}
+
+template <>
+inline cl_int Event::getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>(cl_int* err) const
+{
+    native::setError(err);
+    return CL_COMPLETE;
+}
+
+} // namespace cl
+
+#endif
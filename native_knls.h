@@ -0,0 +1,120 @@
+/*Crown Copyright 2012 AWE.
+*
+* This file is part of CloverLeaf.
+*
+* CloverLeaf is free software: you can redistribute it and/or modify it under
+* the terms of the GNU General Public License as published by the
+* Free Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* CloverLeaf is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* CloverLeaf. If not, see http://www.gnu.org/licenses/. */
+
+/**
+ *  @brief OpenCL C compatibility for the native kernels.
+ *  @details Included at the top of the work item class in native_kernels.C,
+ *  ahead of the *_knl.cl sources, so each kernel compiles unchanged as a C++
+ *  member function. The address space qualifiers vanish, the work item
+ *  functions read the item's ids, and the constants the OpenCL build passes
+ *  as -D options read the values the program was built with. Those are plain
+ *  names, so an #if on one of them sees 0. The kernels that synchronise a
+ *  work group at a barrier are not run through here; native_kernels.C runs
+ *  them as loops of its own.
+ */
+
+#define __kernel __attribute__((always_inline)) inline
+#define __global
+#define __local
+#define __constant const
+#define restrict __restrict__
+
+#define CLK_LOCAL_MEM_FENCE 1
+#define CLK_GLOBAL_MEM_FENCE 2
+
+#define XMIN xmin_
+#define XMINPLUSONE (xmin_+1)
+#define XMAX xmax_
+#define XMAXPLUSONE (xmax_+1)
+#define XMAXPLUSTWO (xmax_+2)
+#define XMAXPLUSTHREE (xmax_+3)
+#define XMAXPLUSFOUR (xmax_+4)
+#define XMAXPLUSFIVE (xmax_+5)
+#define YMIN ymin_
+#define YMINPLUSONE (ymin_+1)
+#define YMINPLUSTWO (ymin_+2)
+#define YMAX ymax_
+#define YMAXPLUSONE (ymax_+1)
+#define YMAXPLUSTWO (ymax_+2)
+#define YMAXPLUSTHREE (ymax_+3)
+#define YMAXPLUSFOUR (ymax_+4)
+#define WORKGROUP_SIZE workgroup_size_
+#define WORKGROUP_SIZE_DIVTWO (workgroup_size_/2)
+#define CALCDT_WG_X calcdt_wg_x_
+#define CALCDT_WG_Y calcdt_wg_y_
+#define ADVEC_WG_X advec_wg_x_
+#define ADVEC_WG_Y advec_wg_y_
+#define ADVMOM_WG_X advmom_wg_x_
+#define ADVMOM_WG_Y advmom_wg_y_
+#define ENSEMBLE_MEMBERS ensemble_members_
+#define MEMBER_YMAX member_ymax_
+#define EXTERNAL_FACES external_faces_
+
+typedef unsigned int uint;
+
+int xmin_, xmax_, ymin_, ymax_;
+int workgroup_size_, calcdt_wg_x_, calcdt_wg_y_, advec_wg_x_, advec_wg_y_, advmom_wg_x_, advmom_wg_y_;
+int ensemble_members_, member_ymax_, external_faces_;
+
+::size_t global_id_[3];
+::size_t global_offset_[3];
+::size_t global_size_[3];
+::size_t local_size_[3];
+
+void setLaunch(cl::native::Launch const& launch)
+{
+    cl::native::Defines const& defines = *launch.defines;
+
+    xmin_ = defines.xmin;
+    xmax_ = defines.xmax;
+    ymin_ = defines.ymin;
+    ymax_ = defines.ymax;
+    workgroup_size_ = defines.workgroup_size;
+    calcdt_wg_x_ = defines.calcdt_wg_x;
+    calcdt_wg_y_ = defines.calcdt_wg_y;
+    advec_wg_x_ = defines.advec_wg_x;
+    advec_wg_y_ = defines.advec_wg_y;
+    advmom_wg_x_ = defines.advmom_wg_x;
+    advmom_wg_y_ = defines.advmom_wg_y;
+    ensemble_members_ = defines.ensemble_members;
+    member_ymax_ = defines.member_ymax;
+    external_faces_ = defines.external_faces;
+
+    for (int d = 0; d < 3; d++) {
+        global_id_[d] = launch.offset[d];
+        global_offset_[d] = launch.offset[d];
+        global_size_[d] = launch.global[d];
+        local_size_[d] = launch.local[d];
+    }
+}
+
+::size_t get_global_id(uint d) const { return global_id_[d]; }
+::size_t get_global_size(uint d) const { return global_size_[d]; }
+::size_t get_local_size(uint d) const { return local_size_[d]; }
+::size_t get_num_groups(uint d) const { return global_size_[d]/local_size_[d]; }
+::size_t get_local_id(uint d) const { return (global_id_[d]-global_offset_[d]) % local_size_[d]; }
+::size_t get_group_id(uint d) const { return (global_id_[d]-global_offset_[d]) / local_size_[d]; }
+
+static void barrier(int /* flags */) {}
+static void read_mem_fence(int /* flags */) {}
+static void write_mem_fence(int /* flags */) {}
+
+static int atomic_inc(volatile int* p) { return __sync_fetch_and_add(p, 1); }
+static int popcount(int x) { return __builtin_popcount(x); }
+
+template <typename T> static T min(T a, T b) { return b < a ? b : a; }
+template <typename T> static T max(T a, T b) { return a < b ? b : a; }
@@ -7,9 +7,214 @@
 #pragma OPENCL EXTENSION cl_amd_fp64 : enable
 #endif
 
+#ifdef SUBGROUP_REDUCTION
+#pragma OPENCL EXTENSION cl_khr_subgroups : enable
+#endif
+
+/* Storage type of the mesh fields, set with the host's CLOVER_MIXED_PRECISION.
+ * Loads widen to double, so kernels compute, reduce and keep their work
+ * arrays and flux sums in double whichever type the fields are stored as,
+ * apart from the kernels that compute in calc_t */
+#ifdef CLOVER_MIXED_PRECISION
+typedef float field_t;
+#else
+typedef double field_t;
+#endif
+
+/* Arithmetic type of the point-wise kernels whose results go straight back
+ * to field storage with no sums over cells: the equation of state, the
+ * viscosity and the acceleration. A mixed build computes them in float,
+ * while PdV, the fluxes, advection and the reductions stay double. CALC
+ * gives a literal the same type, so it does not widen the expression */
+#ifdef CLOVER_MIXED_PRECISION
+typedef float calc_t;
+#else
+typedef double calc_t;
+#endif
+
+#define CALC(value) ((calc_t) (value))
+
 #define ARRAYXY(x_index, y_index, x_width) ((y_index)*(x_width)+(x_index))
 
 #define ARRAY1D(i_index,i_lb) ((i_index)-(i_lb))
 #define ARRAY2D(i_index,j_index,i_size,i_lb,j_lb) ((i_size)*((j_index)-(j_lb))+(i_index)-(i_lb))
 
+/* Fields are numbered as in the Fortran fields array, 1 to NUM_FIELDS */
+#define NUM_FIELDS 15
+
+#define HALO_FACE_BOTTOM 1
+#define HALO_FACE_TOP    2
+#define HALO_FACE_LEFT   4
+#define HALO_FACE_RIGHT  8
+
+/* Faces of this chunk on the edge of the mesh, set by the host for each
+ * program so the halo kernels drop the faces the chunk never reflects */
+#ifndef EXTERNAL_FACES
+#define EXTERNAL_FACES (HALO_FACE_BOTTOM | HALO_FACE_TOP | HALO_FACE_LEFT | HALO_FACE_RIGHT)
+#endif
+
+/* Range guard of the point-wise kernels. The INTERIOR_TILES program is only
+ * launched over whole work-groups inside the range, so its test folds away */
+#ifdef INTERIOR_TILES
+#define IN_RANGE(test) 1
+#else
+#define IN_RANGE(test) (test)
+#endif
+
+/* An ensemble build stacks ENSEMBLE_MEMBERS meshes of MEMBER_YMAX rows in y,
+ * each with its own halo rows and a spare row so that their vertex halos do
+ * not overlap. YMAX then spans the whole stack. Rows are the 0 based k of the
+ * kernels, and each member reads its own dt */
+#ifdef ENSEMBLE_MEMBERS
+#define MEMBER_ROWS (MEMBER_YMAX+5)
+#define MEMBER_OF(row) min((int)(row)/MEMBER_ROWS, ENSEMBLE_MEMBERS-1)
+#define MEMBER_ROW(row) ((int)(row)%MEMBER_ROWS)
+#else
+#define ENSEMBLE_MEMBERS 1
+#define MEMBER_YMAX YMAX
+#define MEMBER_ROWS 0
+#define MEMBER_OF(row) 0
+#define MEMBER_ROW(row) (row)
+#endif
+
+#define MEMBER_DT(dt_value, row) ((dt_value)[MEMBER_OF(row)])
+
+#define HALO_FIELD_SET(mask, field_id) (((mask) >> ((field_id)-1)) & 1)
+
+/* Position of a field in a message that holds every field in the mask */
+#define HALO_FIELD_SLOT(mask, field_id) popcount((mask) & ((1 << ((field_id)-1)) - 1))
+
+/* Cell 1-7, vertex 8-11, x face 12 and 14, y face 13 and 15 */
+#define FIELD_X_INC(field_id) ((field_id) >= 8 && (field_id) != 13 && (field_id) != 15)
+#define FIELD_Y_INC(field_id) ((field_id) >= 8 && (field_id) != 12 && (field_id) != 14)
+
+/*
+ *  Timestep of cell j, k from the CFL condition, the velocity gradients and
+ *  the velocity divergence, given the cell's sound speed, viscosity and
+ *  density. control is set to the limiting condition
+ *  (1 sound, 2 xvel, 3 yvel, 4 div)
+ */
+inline double calc_dt_cell(
+        const int j,
+        const int k,
+        const double g_small,
+        const double g_big,
+        const double dtc_safe,
+        const double dtu_safe,
+        const double dtv_safe,
+        const double dtdiv_safe,
+        const double sound_speed,
+        const double visc,
+        const double density,
+        __global const field_t * restrict xarea,
+        __global const field_t * restrict yarea,
+        __global const field_t * restrict celldx,
+        __global const field_t * restrict celldy,
+        __global const field_t * restrict volume,
+        __global const field_t * restrict xvel0,
+        __global const field_t * restrict yvel0,
+        int * control)
+{
+    double dsx,dsy,cc,dv1,dv2,div,dtct,dtut,dtvt,dtdivt,dt_cell;
+
+    dsx = celldx[j];
+    dsy = celldy[k];
+
+    cc = pow(sound_speed, 2);
+    cc = cc + 2.0 * visc / density;
+    cc = fmax(sqrt(cc),g_small);
+
+    dtct = dtc_safe * fmin(dsx,dsy)/cc;
+
+    div = 0.0;
+
+    dv1 = (xvel0[ARRAYXY(j  ,k, XMAXPLUSFIVE)]+xvel0[ARRAYXY(j  ,k+1, XMAXPLUSFIVE)])
+          * xarea[ARRAYXY(j, k, XMAXPLUSFIVE )];
+
+    dv2 = (xvel0[ARRAYXY(j+1, k, XMAXPLUSFIVE)]+ xvel0[ARRAYXY(j+1, k+1, XMAXPLUSFIVE)])
+          * xarea[ARRAYXY(j+1, k, XMAXPLUSFIVE)];
+
+    div = div + dv2 - dv1;
+
+    dtut = dtu_safe * 2.0 * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] 
+           / fmax(fabs(dv1), fmax( fabs(dv2), g_small * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] ) );
+
+    dv1 = ( yvel0[ARRAYXY(j, k, XMAXPLUSFIVE)]+yvel0[ARRAYXY(j+1, k, XMAXPLUSFIVE)])
+          * yarea[ARRAYXY(j, k, XMAXPLUSFOUR)];
+
+    dv2 = ( yvel0[ARRAYXY(j, k+1, XMAXPLUSFIVE)] + yvel0[ARRAYXY(j+1, k+1, XMAXPLUSFIVE)]) 
+          * yarea[ARRAYXY(j, k+1, XMAXPLUSFOUR)];
+
+    div = div + dv2 - dv1; 
+
+    dtvt = dtv_safe * 2.0 * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] 
+           / fmax( fabs(dv1), fmax( fabs(dv2), g_small * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] ) );
+
+    div = div / ( 2.0 * volume[ARRAYXY(j, k, XMAXPLUSFOUR)] );
+
+    if (div < (-1*g_small)) {
+        dtdivt = dtdiv_safe * (-1.0/div); 
+    } else {
+        dtdivt = g_big;
+    }
+
+    dt_cell = fmin( fmin( fmin(dtvt, dtdivt), dtut ), dtct ); 
+
+    *control = (dt_cell == dtct) ? 1 : 
+               (dt_cell == dtut) ? 2 : 
+               (dt_cell == dtvt) ? 3 : 4;
+
+    return dt_cell;
+}
+
+/*
+ *  Cell and limiting condition packed into one value, so the group minimum
+ *  can be traced back to a cell after the reduction. k is numbered within
+ *  the member
+ */
+inline int calc_dt_location(const int j, const int k, const int control)
+{
+    return ((k-2)*XMAX + (j-2))*4 + control-1;
+}
+
+/*
+ *  Work group minimum of dt_min_local and the location that goes with it,
+ *  the result is only valid in the first element
+ */
+inline void calc_dt_workgroup_min(__local double * restrict dt_min_local, __local int * restrict dt_loc_local,
+                           const int localid)
+{
+#ifdef GPU_REDUCTION 
+
+        //GPU reduction 
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        for (int limit = WORKGROUP_SIZE_DIVTWO; limit > 0; limit >>= 1 ) {
+
+            if ( (localid < limit) && (dt_min_local[localid + limit] < dt_min_local[localid]) ) {
+            
+                dt_min_local[localid] = dt_min_local[localid + limit];
+                dt_loc_local[localid] = dt_loc_local[localid + limit];
+
+            }
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+
+#else
+
+        //CPU reduction 
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        if (localid==0) {
+            for (int index = 1; index < WORKGROUP_SIZE; index++) {
+                if (dt_min_local[index] < dt_min_local[localid]) {
+                    dt_min_local[localid] = dt_min_local[index];
+                    dt_loc_local[localid] = dt_loc_local[index];
+                }
+            }
+        }
+
+#endif
+}
+
 #endif
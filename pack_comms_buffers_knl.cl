@@ -27,7 +27,7 @@ __kernel void left_comm_buffer_pack(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global const double * restrict field,
+    __global const field_t * restrict field,
     __global double * restrict snd_buffer)
 {
     int k = get_global_id(1);
@@ -47,7 +47,7 @@ __kernel void right_comm_buffer_pack(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global const double * restrict field,
+    __global const field_t * restrict field,
     __global double * restrict snd_buffer)
 {
     int k = get_global_id(1);
@@ -67,7 +67,7 @@ __kernel void top_comm_buffer_pack(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global const double * restrict field,
+    __global const field_t * restrict field,
     __global double * restrict snd_buffer)
 {
     int k = get_global_id(1);
@@ -88,7 +88,7 @@ __kernel void bottom_comm_buffer_pack(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global const double * restrict field,
+    __global const field_t * restrict field,
     __global double * restrict snd_buffer)
 {
     int k = get_global_id(1);
@@ -104,3 +104,106 @@ __kernel void bottom_comm_buffer_pack(
 
     }
 }
+
+/*
+ * Pack every field in the mask into one message per face. Each field takes
+ * a slot of stride values, in Fortran field order, so the receiver can find
+ * it from the same mask.
+ */
+__kernel void left_right_comm_buffer_pack_all(
+    const int depth,
+    const int mask,
+    const int faces,
+    const int stride,
+    __global const field_t * restrict density0,
+    __global const field_t * restrict density1,
+    __global const field_t * restrict energy0,
+    __global const field_t * restrict energy1,
+    __global const field_t * restrict pressure,
+    __global const field_t * restrict viscosity,
+    __global const field_t * restrict soundspeed,
+    __global const field_t * restrict xvel0,
+    __global const field_t * restrict xvel1,
+    __global const field_t * restrict yvel0,
+    __global const field_t * restrict yvel1,
+    __global const field_t * restrict vol_flux_x,
+    __global const field_t * restrict vol_flux_y,
+    __global const field_t * restrict mass_flux_x,
+    __global const field_t * restrict mass_flux_y,
+    __global field_t * restrict left_snd_buffer,
+    __global field_t * restrict right_snd_buffer)
+{
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    __global const field_t * fields[NUM_FIELDS] = { density0, density1, energy0, energy1, pressure,
+                                                   viscosity, soundspeed, xvel0, xvel1, yvel0, yvel1,
+                                                   vol_flux_x, vol_flux_y, mass_flux_x, mass_flux_y };
+
+    for (int f = 1; f <= NUM_FIELDS; f++) {
+
+        int x_inc = FIELD_X_INC(f);
+        int y_inc = FIELD_Y_INC(f);
+
+        if ( HALO_FIELD_SET(mask, f) && (k>=2-depth) && (k<=YMAXPLUSONE+y_inc+depth) ) {
+
+            int index = HALO_FIELD_SLOT(mask, f)*stride + j + (k+depth-2)*depth;
+
+            if (faces & HALO_FACE_LEFT) {
+                left_snd_buffer[index] = fields[f-1][ ARRAYXY( XMINPLUSONE+x_inc+j, k, XMAXPLUSFOUR+x_inc ) ];
+            }
+            if (faces & HALO_FACE_RIGHT) {
+                right_snd_buffer[index] = fields[f-1][ ARRAYXY( XMAXPLUSONE-j, k, XMAXPLUSFOUR+x_inc ) ];
+            }
+        }
+    }
+}
+
+__kernel void top_bottom_comm_buffer_pack_all(
+    const int depth,
+    const int mask,
+    const int faces,
+    const int stride,
+    __global const field_t * restrict density0,
+    __global const field_t * restrict density1,
+    __global const field_t * restrict energy0,
+    __global const field_t * restrict energy1,
+    __global const field_t * restrict pressure,
+    __global const field_t * restrict viscosity,
+    __global const field_t * restrict soundspeed,
+    __global const field_t * restrict xvel0,
+    __global const field_t * restrict xvel1,
+    __global const field_t * restrict yvel0,
+    __global const field_t * restrict yvel1,
+    __global const field_t * restrict vol_flux_x,
+    __global const field_t * restrict vol_flux_y,
+    __global const field_t * restrict mass_flux_x,
+    __global const field_t * restrict mass_flux_y,
+    __global field_t * restrict bottom_snd_buffer,
+    __global field_t * restrict top_snd_buffer)
+{
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    __global const field_t * fields[NUM_FIELDS] = { density0, density1, energy0, energy1, pressure,
+                                                   viscosity, soundspeed, xvel0, xvel1, yvel0, yvel1,
+                                                   vol_flux_x, vol_flux_y, mass_flux_x, mass_flux_y };
+
+    for (int f = 1; f <= NUM_FIELDS; f++) {
+
+        int x_inc = FIELD_X_INC(f);
+        int y_inc = FIELD_Y_INC(f);
+
+        if ( HALO_FIELD_SET(mask, f) && (j>=2-depth) && (j<=XMAXPLUSONE+x_inc+depth) ) {
+
+            int index = HALO_FIELD_SLOT(mask, f)*stride + j - (2-depth) + k*(XMAX+x_inc+(2*depth));
+
+            if (faces & HALO_FACE_BOTTOM) {
+                bottom_snd_buffer[index] = fields[f-1][ ARRAYXY( j, YMINPLUSONE+y_inc+k, XMAXPLUSFOUR+x_inc ) ];
+            }
+            if (faces & HALO_FACE_TOP) {
+                top_snd_buffer[index] = fields[f-1][ ARRAYXY( j, YMAXPLUSONE-k, XMAXPLUSFOUR+x_inc ) ];
+            }
+        }
+    }
+}
@@ -27,27 +27,28 @@
 #include "ocl_knls.h"
 
 __kernel void pdv_correct_ocl_kernel(
-        const double dt,
-        __global const double * restrict xarea,
-        __global const double * restrict yarea,
-        __global const double * restrict volume,
-        __global const double * restrict density0,
-        __global double * restrict density1,
-        __global const double * restrict energy0,
-        __global double * restrict energy1,
-        __global const double * restrict pressure,
-        __global const double * restrict viscosity,
-        __global const double * restrict xvel0,
-        __global const double * restrict xvel1,
-        __global const double * restrict yvel0,
-        __global const double * restrict yvel1)
+        __global const double * restrict dt_value,
+        __global const field_t * restrict xarea,
+        __global const field_t * restrict yarea,
+        __global const field_t * restrict volume,
+        __global const field_t * restrict density0,
+        __global field_t * restrict density1,
+        __global const field_t * restrict energy0,
+        __global field_t * restrict energy1,
+        __global const field_t * restrict pressure,
+        __global const field_t * restrict viscosity,
+        __global const field_t * restrict xvel0,
+        __global const field_t * restrict xvel1,
+        __global const field_t * restrict yvel0,
+        __global const field_t * restrict yvel1)
 {
+  const double dt = MEMBER_DT(dt_value, get_global_id(1));
   double recip_volume,energy_change,min_cell_volume,right_flux,left_flux,top_flux,bottom_flux,total_flux,volume_change;
 
   int j = get_global_id(0);
   int k = get_global_id(1);
 
-  if((j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE)) {
+  if(IN_RANGE((j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE))) {
         left_flux=  (xarea[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)])
                                    *(xvel0[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)]
                                     +xvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)]
@@ -95,27 +96,28 @@ __kernel void pdv_correct_ocl_kernel(
 }
 
 __kernel void pdv_predict_ocl_kernel(
-        const double dt,
-        __global const double * restrict xarea,
-        __global const double * restrict yarea,
-        __global const double * restrict volume,
-        __global const double * restrict density0,
-        __global double * restrict density1,
-        __global const double * restrict energy0,
-        __global double * restrict energy1,
-        __global const double * restrict pressure,
-        __global const double * restrict viscosity,
-        __global const double * restrict xvel0,
-        __global const double * restrict xvel1,
-        __global const double * restrict yvel0,
-        __global const double * restrict yvel1)
+        __global const double * restrict dt_value,
+        __global const field_t * restrict xarea,
+        __global const field_t * restrict yarea,
+        __global const field_t * restrict volume,
+        __global const field_t * restrict density0,
+        __global field_t * restrict density1,
+        __global const field_t * restrict energy0,
+        __global field_t * restrict energy1,
+        __global const field_t * restrict pressure,
+        __global const field_t * restrict viscosity,
+        __global const field_t * restrict xvel0,
+        __global const field_t * restrict xvel1,
+        __global const field_t * restrict yvel0,
+        __global const field_t * restrict yvel1)
 {
+  const double dt = MEMBER_DT(dt_value, get_global_id(1));
   double recip_volume,energy_change,min_cell_volume,right_flux,left_flux,top_flux,bottom_flux,total_flux,volume_change;
 
   int j = get_global_id(0);
   int k = get_global_id(1);
 
-  if((j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE)) {
+  if(IN_RANGE((j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE))) {
         left_flux=  (xarea[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)])
                                    *(xvel0[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)]
                                     +xvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)]
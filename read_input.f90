@@ -6,7 +6,7 @@ SUBROUTINE read_input()
 
   IMPLICIT NONE
 
-  INTEGER            :: state,stat,state_max
+  INTEGER            :: state,stat,state_max,member,deck_unit,ios
 
   CHARACTER(LEN=500) :: word
 
@@ -15,6 +15,7 @@ SUBROUTINE read_input()
   test_problem=0
 
   state_max=0
+  number_of_members=1
 
   grid%xmin=  0.0
   grid%ymin=  0.0
@@ -28,6 +29,12 @@ SUBROUTINE read_input()
   end_step=g_ibig
 
   visit_frequency=0
+  checkpoint_frequency=0
+  checkpoint_path='.'
+  restart_run=.FALSE.
+  balance_calibration_steps=0
+  balance_tolerance=1.25_8
+  summary_baseline=''
   summary_frequency=10
 
   dtinit=0.1
@@ -44,9 +51,25 @@ SUBROUTINE read_input()
   use_OA_kernels=.FALSE.
   use_vector_loops=.FALSE.
   use_OpenCL_kernels=.FALSE.
+  use_native_kernels=.FALSE.
 
   OpenCL_vendor = 'NULL'
   OpenCL_type = 'NULL'
+  OpenCL_autotune=.FALSE.
+  OpenCL_fused_timestep=.FALSE.
+  OpenCL_async_dt=.FALSE.
+  OpenCL_single_reduction=.FALSE.
+  OpenCL_batched_halo=.FALSE.
+  OpenCL_pipelined_exchange=.FALSE.
+  OpenCL_pinned_staging=.FALSE.
+  OpenCL_buffer_swap=.FALSE.
+  OpenCL_fused_advec_cell=.FALSE.
+  OpenCL_fused_advec_mom=.FALSE.
+  OpenCL_binary_vis=.FALSE.
+  OpenCL_event_profile=.FALSE.
+  OpenCL_step_replay=.FALSE.
+  OpenCL_async_summary=.FALSE.
+  OpenCL_interior_tiles=.FALSE.
 
   IF(parallel%boss)WRITE(g_out,*) 'Reading input file'
   IF(parallel%boss)WRITE(g_out,*)
@@ -63,9 +86,53 @@ SUBROUTINE read_input()
         state_max=MAX(state_max,parse_getival(parse_getword(.TRUE.)))
         EXIT
       ENDIF
+      IF (word.EQ.'ensemble_deck') THEN
+        number_of_members=number_of_members+1
+        EXIT
+      ENDIF
     ENDDO
   ENDDO
 
+  ! The other members of an ensemble only contribute their states, so every
+  ! member has as many states as the deck with the most
+  ALLOCATE(ensemble_decks(number_of_members))
+  ensemble_decks(1)='clover.in'
+
+  IF(number_of_members.GT.1) THEN
+    stat=parse_init(g_in,'*clover')
+    member=1
+    DO
+      stat=parse_getline(dummy)
+      IF (stat.ne.0) exit
+      DO
+        word=parse_getword(.FALSE.)
+        IF(word.EQ.'')EXIT
+        IF (word.EQ.'ensemble_deck') THEN
+          member=member+1
+          ensemble_decks(member)=TRIM(parse_getword(.TRUE.))
+          EXIT
+        ENDIF
+      ENDDO
+    ENDDO
+
+    DO member=2,number_of_members
+      CALL open_deck(member)
+      DO
+        stat=parse_getline(dummy)
+        IF (stat.ne.0) exit
+        DO
+          word=parse_getword(.FALSE.)
+          IF(word.EQ.'')EXIT
+          IF (word.EQ.'state') THEN
+            state_max=MAX(state_max,parse_getival(parse_getword(.TRUE.)))
+            EXIT
+          ENDIF
+        ENDDO
+      ENDDO
+      CLOSE(deck_unit)
+    ENDDO
+  ENDIF
+
   number_of_states=state_max
 
   IF(number_of_states.LT.1) CALL report_error('read_input','No states defined.')
@@ -78,6 +145,7 @@ SUBROUTINE read_input()
   states(:)%density=0.0
   states(:)%xvel=0.0
   states(:)%yvel=0.0
+  states(:)%geometry=0
 
   DO
     stat=parse_getline(dummy)
@@ -125,6 +193,24 @@ SUBROUTINE read_input()
       CASE('visit_frequency')
         visit_frequency=parse_getival(parse_getword(.TRUE.))
         IF(parallel%boss)WRITE(g_out,"(1x,a25,i12)")'visit_frequency',visit_frequency
+      CASE('checkpoint_frequency')
+        checkpoint_frequency=parse_getival(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,i12)")'checkpoint_frequency',checkpoint_frequency
+      CASE('checkpoint_path')
+        checkpoint_path=TRIM(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,a)")'checkpoint_path ',TRIM(checkpoint_path)
+      CASE('restart')
+        restart_run=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'restart'
+      CASE('balance_calibration_steps')
+        balance_calibration_steps=parse_getival(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,i12)")'balance_calibration_steps',balance_calibration_steps
+      CASE('balance_tolerance')
+        balance_tolerance=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'balance_tolerance',balance_tolerance
+      CASE('summary_baseline')
+        summary_baseline=TRIM(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,a)")'summary_baseline ',TRIM(summary_baseline)
       CASE('summary_frequency')
         summary_frequency=parse_getival(parse_getword(.TRUE.))
         IF(parallel%boss)WRITE(g_out,"(1x,a25,i12)")'summary_frequency',summary_frequency
@@ -154,67 +240,98 @@ SUBROUTINE read_input()
         use_C_kernels=.FALSE.
         use_OA_kernels=.FALSE.
         use_OpenCL_kernels=.TRUE.
+      CASE('use_native_kernels')
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'Using native kernels...'
+        use_fortran_kernels=.TRUE.
+        use_C_kernels=.FALSE.
+        use_OA_kernels=.FALSE.
+        use_OpenCL_kernels=.TRUE.
+        use_native_kernels=.TRUE.
       CASE('opencl_vendor')
         OpenCL_vendor = TRIM(parse_getword(.TRUE.))
       CASE('opencl_type')
         OpenCL_type=TRIM(parse_getword(.TRUE.))
+      CASE('opencl_autotune')
+        OpenCL_autotune=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_autotune'
+      CASE('opencl_fused_timestep')
+        OpenCL_fused_timestep=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_fused_timestep'
+      CASE('opencl_async_dt')
+        OpenCL_async_dt=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_async_dt'
+      CASE('opencl_single_reduction')
+        OpenCL_single_reduction=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_single_reduction'
+      CASE('opencl_batched_halo')
+        OpenCL_batched_halo=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_batched_halo'
+      CASE('opencl_pipelined_exchange')
+        OpenCL_pipelined_exchange=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_pipelined_exchange'
+      CASE('opencl_pinned_staging')
+        OpenCL_pinned_staging=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_pinned_staging'
+      CASE('opencl_buffer_swap')
+        OpenCL_buffer_swap=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_buffer_swap'
+      CASE('opencl_fused_advec_cell')
+        OpenCL_fused_advec_cell=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_fused_advec_cell'
+      CASE('opencl_fused_advec_mom')
+        OpenCL_fused_advec_mom=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_fused_advec_mom'
+      CASE('opencl_binary_vis')
+        OpenCL_binary_vis=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_binary_vis'
+      CASE('opencl_event_profile')
+        OpenCL_event_profile=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_event_profile'
+      CASE('opencl_step_replay')
+        OpenCL_step_replay=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_step_replay'
+      CASE('opencl_async_summary')
+        OpenCL_async_summary=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_async_summary'
+      CASE('opencl_interior_tiles')
+        OpenCL_interior_tiles=.TRUE.
+        IF(parallel%boss)WRITE(g_out,"(1x,a25)")'opencl_interior_tiles'
+      CASE('ensemble_deck')
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,a)")'ensemble_deck ',TRIM(parse_getword(.TRUE.))
       CASE('state')
+        CALL read_state(states)
+      END SELECT
+    ENDDO
+  ENDDO
 
-        state=parse_getival(parse_getword(.TRUE.))
+  ! Only the states are read from the decks of the other ensemble members
+  ALLOCATE(member_states(number_of_states,number_of_members))
+  member_states(:,1)=states
 
-        IF(parallel%boss)WRITE(g_out,*)'Reading specification for state ',state
-        IF (states(state)%defined) CALL report_error('read_input','State defined twice.')
-        IF(parallel%boss) WRITE(g_out,*)
+  DO member=2,number_of_members
+    member_states(:,member)%defined=.FALSE.
+    member_states(:,member)%energy=0.0
+    member_states(:,member)%density=0.0
+    member_states(:,member)%xvel=0.0
+    member_states(:,member)%yvel=0.0
+    member_states(:,member)%geometry=0
 
-        states(state)%defined=.TRUE.
-        DO
-          word=parse_getword(.FALSE.)
-          IF(word.EQ.'') EXIT
-
-          SELECT CASE(word)
-
-          CASE('xvel')
-            states(state)%xvel=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'xvel ',states(state)%xvel
-          CASE('yvel')
-            states(state)%yvel=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'yvel ',states(state)%yvel
-          CASE('xmin')
-            states(state)%xmin=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state xmin ',states(state)%xmin
-          CASE('ymin')
-            states(state)%ymin=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state ymin ',states(state)%ymin
-          CASE('xmax')
-            states(state)%xmax=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state xmax ',states(state)%xmax
-          CASE('ymax')
-            states(state)%ymax=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state ymax ',states(state)%ymax
-          CASE('radius')
-            states(state)%radius=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state radius ',states(state)%radius
-          CASE('density')
-            states(state)%density=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state density ',states(state)%density
-          CASE('energy')
-            states(state)%energy=parse_getrval(parse_getword(.TRUE.))
-            IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state energy ',states(state)%energy
-          CASE('geometry')
-            word=TRIM(parse_getword(.TRUE.))
-            SELECT CASE(word)
-            CASE("rectangle")
-              states(state)%geometry=g_rect
-              IF(parallel%boss)WRITE(g_out,"(1x,a26)")'state geometry rectangular'
-            CASE("circle")
-              states(state)%geometry=g_circ
-              IF(parallel%boss)WRITE(g_out,"(1x,a25)")'state geometry circular'
-            END SELECT
-          END SELECT
-        ENDDO
-        IF(parallel%boss) WRITE(g_out,*)
-      END SELECT
+    IF(parallel%boss)WRITE(g_out,*)'Reading states of ensemble member ',member,' from ',TRIM(ensemble_decks(member))
+    IF(parallel%boss)WRITE(g_out,*)
+
+    CALL open_deck(member)
+    DO
+      stat=parse_getline(dummy)
+      IF(stat.NE.0)EXIT
+      DO
+        word=parse_getword(.FALSE.)
+        IF(word.EQ.'')EXIT
+        IF(word.EQ.'state') CALL read_state(member_states(:,member))
+      ENDDO
     ENDDO
+    CLOSE(deck_unit)
+
+    IF(.NOT.member_states(1,member)%defined) CALL report_error('read_input','Ensemble member has no state 1.')
   ENDDO
 
   IF(parallel%boss) THEN
@@ -226,7 +343,9 @@ SUBROUTINE read_input()
     ELSEIF(use_oa_kernels) THEN
       WRITE(g_out,"(1x,a25)")'Using OpenAcc Kernels'
     ENDIF
-    IF(use_OpenCL_kernels) THEN
+    IF(use_native_kernels) THEN
+      WRITE(g_out,"(1x,a25)")'Using Native Kernels'
+    ELSEIF(use_OpenCL_kernels) THEN
       WRITE(g_out,"(1x,a25)")'Using OpenCL Kernels'
       WRITE(g_out, "(1x,a16,a50)") 'OpenCL_vendor =', OpenCL_vendor
       WRITE(g_out, "(1x,a16,a50)") 'OpenCL_type =', OpenCL_type
@@ -236,4 +355,82 @@ SUBROUTINE read_input()
     WRITE(g_out,*)
   ENDIF
 
+CONTAINS
+
+  SUBROUTINE open_deck(member)
+
+    ! Opens the deck of an ensemble member for parsing
+
+    INTEGER :: member
+    INTEGER :: get_unit
+
+    deck_unit=get_unit(dummy)
+    OPEN(FILE=TRIM(ensemble_decks(member)),ACTION='READ',STATUS='OLD',UNIT=deck_unit,IOSTAT=ios)
+    IF(ios.NE.0) CALL report_error('read_input','Error opening an ensemble deck')
+    stat=parse_init(deck_unit,'*clover')
+
+  END SUBROUTINE open_deck
+
+  SUBROUTINE read_state(deck_states)
+
+    ! Reads the rest of a state line into the states of a deck
+
+    TYPE(state_type) :: deck_states(:)
+
+    state=parse_getival(parse_getword(.TRUE.))
+
+    IF(parallel%boss)WRITE(g_out,*)'Reading specification for state ',state
+    IF (deck_states(state)%defined) CALL report_error('read_input','State defined twice.')
+    IF(parallel%boss) WRITE(g_out,*)
+
+    deck_states(state)%defined=.TRUE.
+    DO
+      word=parse_getword(.FALSE.)
+      IF(word.EQ.'') EXIT
+
+      SELECT CASE(word)
+
+      CASE('xvel')
+        deck_states(state)%xvel=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'xvel ',deck_states(state)%xvel
+      CASE('yvel')
+        deck_states(state)%yvel=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'yvel ',deck_states(state)%yvel
+      CASE('xmin')
+        deck_states(state)%xmin=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state xmin ',deck_states(state)%xmin
+      CASE('ymin')
+        deck_states(state)%ymin=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state ymin ',deck_states(state)%ymin
+      CASE('xmax')
+        deck_states(state)%xmax=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state xmax ',deck_states(state)%xmax
+      CASE('ymax')
+        deck_states(state)%ymax=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state ymax ',deck_states(state)%ymax
+      CASE('radius')
+        deck_states(state)%radius=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state radius ',deck_states(state)%radius
+      CASE('density')
+        deck_states(state)%density=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state density ',deck_states(state)%density
+      CASE('energy')
+        deck_states(state)%energy=parse_getrval(parse_getword(.TRUE.))
+        IF(parallel%boss)WRITE(g_out,"(1x,a25,e12.4)")'state energy ',deck_states(state)%energy
+      CASE('geometry')
+        word=TRIM(parse_getword(.TRUE.))
+        SELECT CASE(word)
+        CASE("rectangle")
+          deck_states(state)%geometry=g_rect
+          IF(parallel%boss)WRITE(g_out,"(1x,a26)")'state geometry rectangular'
+        CASE("circle")
+          deck_states(state)%geometry=g_circ
+          IF(parallel%boss)WRITE(g_out,"(1x,a25)")'state geometry circular'
+        END SELECT
+      END SELECT
+    ENDDO
+    IF(parallel%boss) WRITE(g_out,*)
+
+  END SUBROUTINE read_state
+
 END SUBROUTINE read_input
@@ -27,15 +27,15 @@
 #include "ocl_knls.h"
 
 __kernel void revert_ocl_kernel(
-    __global const double * restrict density0,
-    __global double * restrict density1,
-    __global const double * restrict energy0,
-    __global double * restrict energy1)
+    __global const field_t * restrict density0,
+    __global field_t * restrict density1,
+    __global const field_t * restrict energy0,
+    __global field_t * restrict energy1)
 {
     int  k = get_global_id(1);
     int  j = get_global_id(0);
 
-    if ((j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE)) {
+    if (IN_RANGE((j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE))) {
 
         density1[ARRAYXY(j,k,XMAXPLUSFOUR)] = density0[ARRAYXY(j,k,XMAXPLUSFOUR)];
         energy1[ARRAYXY(j,k,XMAXPLUSFOUR)] = energy0[ARRAYXY(j,k,XMAXPLUSFOUR)];
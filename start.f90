@@ -28,7 +28,9 @@ SUBROUTINE start
   USE parse_module
   USE update_halo_module
   USE ideal_gas_module
+  USE calc_dt_module
   USE definitions_module
+  USE report_module
 
   IMPLICIT NONE
 
@@ -36,9 +38,23 @@ SUBROUTINE start
 
   INTEGER :: x_cells,y_cells
   INTEGER, ALLOCATABLE :: right(:),left(:),top(:),bottom(:)
+  REAL(KIND=8), ALLOCATABLE :: weights(:)
 
   INTEGER :: fields(NUM_FIELDS)
 
+  INTEGER :: ocl_autotune
+  INTEGER :: ocl_single_reduction
+  INTEGER :: ocl_batched_halo
+  INTEGER :: ocl_pipelined_exchange
+  INTEGER :: ocl_pinned_staging
+  INTEGER :: ocl_buffer_swap
+  INTEGER :: ocl_fused_advec
+  INTEGER :: ocl_fused_mom
+  INTEGER :: ocl_event_profile
+  INTEGER :: ocl_step_replay
+  INTEGER :: ocl_interior_tiles
+  INTEGER :: ocl_native
+
   IF(parallel%boss)THEN
      WRITE(g_out,*) 'Setting up initial geometry'
      WRITE(g_out,*)
@@ -49,6 +65,15 @@ SUBROUTINE start
   dtold = dtinit
   dt    = dtinit
 
+  ALLOCATE(member_dt(number_of_members))
+  ALLOCATE(member_dtold(number_of_members))
+  ALLOCATE(member_time(number_of_members))
+  ALLOCATE(member_active(number_of_members))
+  member_dt     = dtinit
+  member_dtold  = dtinit
+  member_time   = 0.0
+  member_active = .TRUE.
+
   CALL clover_barrier
 
   CALL clover_get_num_chunks(number_of_chunks)
@@ -59,73 +84,128 @@ SUBROUTINE start
   ALLOCATE(bottom(1:number_of_chunks))
   ALLOCATE(top(1:number_of_chunks))
 
-  CALL clover_decompose(grid%x_cells,grid%y_cells,left,right,bottom,top)
-
-  DO c=1,number_of_chunks
-      
-    ! Needs changing so there can be more than 1 chunk per task
-    chunks(c)%task = c-1
-
-    x_cells = right(c) -left(c)  +1
-    y_cells = top(c)   -bottom(c)+1
-      
-    IF(chunks(c)%task.EQ.parallel%task)THEN
-      CALL build_field(c,x_cells,y_cells)
+  ! The members of an ensemble are stacked in a single chunk, with their own dt
+  IF(number_of_members.GT.1) THEN
+    IF(number_of_chunks.GT.1) CALL report_error('start','An ensemble runs as a single chunk')
+    IF(visit_frequency.NE.0.OR.checkpoint_frequency.NE.0.OR.restart_run) THEN
+      CALL report_error('start','An ensemble cannot be visualised or checkpointed')
+    ENDIF
+    IF(OpenCL_step_replay) THEN
+      OpenCL_step_replay=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_step_replay keeps a single dt, ensemble steps are not replayed'
+    ENDIF
+    IF(OpenCL_fused_timestep) THEN
+      OpenCL_fused_timestep=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_fused_timestep has no ensemble dt kernel, the timestep is not fused'
     ENDIF
-    chunks(c)%field%left    = left(c)
-    chunks(c)%field%bottom  = bottom(c)
-    chunks(c)%field%right   = right(c)
-    chunks(c)%field%top     = top(c)
-    chunks(c)%field%left_boundary   = 1
-    chunks(c)%field%bottom_boundary = 1
-    chunks(c)%field%right_boundary  = grid%x_cells
-    chunks(c)%field%top_boundary    = grid%y_cells
-    chunks(c)%field%x_min = 1
-    chunks(c)%field%y_min = 1
-    chunks(c)%field%x_max = right(c)-left(c)+1
-    chunks(c)%field%y_max = top(c)-bottom(c)+1
-
-  ENDDO
+    IF(OpenCL_async_summary) THEN
+      OpenCL_async_summary=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_async_summary reports a single time, ensemble summaries are waited for'
+    ENDIF
+  ENDIF
 
-  DEALLOCATE(left,right,bottom,top)
+  ! A NATIVE=1 build runs the native kernels for use_opencl_kernels too
+  IF(use_OpenCL_kernels.AND..NOT.use_native_kernels) THEN
+    CALL native_opencl_build(ocl_native)
+    IF(ocl_native.EQ.1) THEN
+      use_native_kernels=.TRUE.
+      IF(parallel%boss) WRITE(g_out,*) 'This is a native build, the OpenCL kernels run natively'
+    ENDIF
+  ENDIF
 
-  ! initialise OpenCL
-  DO c=1,number_of_chunks
-    IF(chunks(c)%task.EQ.parallel%task)THEN
-      ! Append //char(0) to hack around C/Fortran interop
-      CALL setup_opencl(TRIM(OpenCL_vendor)//char(0), TRIM(OpenCL_type)//char(0),&
-                        chunks(c)%field%x_min, chunks(c)%field%x_max, &
-                        chunks(c)%field%y_min, chunks(c)%field%y_max, number_of_states, &
-                        g_small, g_big, dtmin, dtc_safe, dtu_safe, dtv_safe, dtdiv_safe)
+  ! The native kernels run the point-wise sources and the tree reductions only
+  IF(use_native_kernels) THEN
+    IF(OpenCL_fused_timestep) THEN
+      OpenCL_fused_timestep=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_fused_timestep has no native kernel, the timestep is not fused'
+    ENDIF
+    IF(OpenCL_fused_advec_cell) THEN
+      OpenCL_fused_advec_cell=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_fused_advec_cell has no native kernel, advec_cell is not fused'
+    ENDIF
+    IF(OpenCL_fused_advec_mom) THEN
+      OpenCL_fused_advec_mom=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_fused_advec_mom has no native kernel, advec_mom is not fused'
+    ENDIF
+    IF(OpenCL_single_reduction) THEN
+      OpenCL_single_reduction=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_single_reduction has no native kernel, the tree reduction is used'
+    ENDIF
+    IF(OpenCL_step_replay) THEN
+      OpenCL_step_replay=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_step_replay has nothing to save natively, steps are not replayed'
+    ENDIF
+    IF(OpenCL_interior_tiles) THEN
+      OpenCL_interior_tiles=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_interior_tiles has no native kernels, tiles are not specialised'
+    ENDIF
+    IF(OpenCL_autotune) THEN
+      OpenCL_autotune=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_autotune has no work-groups to tune natively, sizes are not swept'
     ENDIF
-  ENDDO
+  ENDIF
 
-  CALL clover_barrier
+  CALL clover_decompose(grid%x_cells,grid%y_cells,left,right,bottom,top)
 
-  DO c=1,number_of_chunks
-    IF(chunks(c)%task.EQ.parallel%task)THEN
-      CALL clover_allocate_buffers(c)
+  ! initialise OpenCL
+  ocl_autotune=0
+  IF(OpenCL_autotune) ocl_autotune=1
+  ocl_single_reduction=0
+  IF(OpenCL_single_reduction) ocl_single_reduction=1
+  ocl_batched_halo=0
+  IF(OpenCL_batched_halo) ocl_batched_halo=1
+  ocl_pipelined_exchange=0
+  IF(OpenCL_pipelined_exchange) ocl_pipelined_exchange=1
+  ocl_pinned_staging=0
+  IF(OpenCL_pinned_staging) ocl_pinned_staging=1
+  ocl_buffer_swap=0
+  IF(OpenCL_buffer_swap) ocl_buffer_swap=1
+  ocl_fused_advec=0
+  IF(OpenCL_fused_advec_cell) ocl_fused_advec=1
+  ocl_fused_mom=0
+  IF(OpenCL_fused_advec_mom) ocl_fused_mom=1
+  ocl_event_profile=0
+  IF(OpenCL_event_profile) ocl_event_profile=1
+  ocl_step_replay=0
+  IF(OpenCL_step_replay) THEN
+    ! A recorded step has no place for the MPI halo exchanges
+    IF(number_of_chunks.EQ.1) THEN
+      ocl_step_replay=1
+    ELSE
+      OpenCL_step_replay=.FALSE.
+      IF(parallel%boss) WRITE(g_out,*) 'opencl_step_replay needs a single chunk, steps are not replayed'
     ENDIF
-  ENDDO
+  ENDIF
 
-  DO c=1,number_of_chunks
-    IF(chunks(c)%task.EQ.parallel%task)THEN
-      CALL initialise_chunk(c)
+  ocl_interior_tiles=0
+  IF(OpenCL_interior_tiles) ocl_interior_tiles=1
+  ocl_native=0
+  IF(use_native_kernels) ocl_native=1
+
+  CALL setup_chunks(.FALSE.)
+
+  ! Size the chunks again in proportion to the throughput each one reached,
+  ! if the ranks turn out to differ by more than the tolerance
+  IF(balance_calibration_steps.GT.0) THEN
+    ALLOCATE(weights(1:number_of_chunks))
+    CALL calibrate_chunk_throughput(weights)
+    IF(MAXVAL(weights).GT.balance_tolerance*MINVAL(weights)) THEN
+      IF(parallel%boss)THEN
+        WRITE(g_out,*) 'Rebalancing the decomposition, chunk throughput ranges from ', &
+                       MINVAL(weights),' to ',MAXVAL(weights),' cells per second'
+      ENDIF
+      CALL clover_decompose(grid%x_cells,grid%y_cells,left,right,bottom,top,weights)
+      CALL setup_chunks(.TRUE.)
     ENDIF
-  ENDDO
-
-  IF(parallel%boss)THEN
-     WRITE(g_out,*) 'Generating chunks'
+    DEALLOCATE(weights)
   ENDIF
 
-  DO c=1,number_of_chunks
-    IF(chunks(c)%task.EQ.parallel%task)THEN
-      CALL generate_chunk(c)
-    ENDIF
-  ENDDO
+  DEALLOCATE(left,right,bottom,top)
 
   advect_x=.TRUE.
 
+  IF(restart_run) CALL restore_checkpoint()
+
   CALL clover_barrier
 
   DO c = 1, number_of_chunks
@@ -158,4 +238,153 @@ SUBROUTINE start
 
   CALL clover_barrier
 
+CONTAINS
+
+  SUBROUTINE setup_chunks(resized)
+
+    ! Sizes every chunk from the decomposition, then sets up its device state
+    ! and generates it. A resized chunk keeps the device set up the first time
+
+    LOGICAL :: resized
+
+    DO c=1,number_of_chunks
+      
+      ! Needs changing so there can be more than 1 chunk per task
+      chunks(c)%task = c-1
+
+      x_cells = right(c) -left(c)  +1
+      y_cells = top(c)   -bottom(c)+1
+
+      ! Each ensemble member has its own two halo rows on either side and a
+      ! spare row, so the vertex rows of neighbouring members do not overlap
+      IF(number_of_members.GT.1) y_cells = number_of_members*(y_cells+5)-4
+      
+      IF(chunks(c)%task.EQ.parallel%task)THEN
+        CALL build_field(c,x_cells,y_cells)
+      ENDIF
+      chunks(c)%field%left    = left(c)
+      chunks(c)%field%bottom  = bottom(c)
+      chunks(c)%field%right   = right(c)
+      chunks(c)%field%top     = top(c)
+      chunks(c)%field%left_boundary   = 1
+      chunks(c)%field%bottom_boundary = 1
+      chunks(c)%field%right_boundary  = grid%x_cells
+      chunks(c)%field%top_boundary    = grid%y_cells
+      chunks(c)%field%x_min = 1
+      chunks(c)%field%y_min = 1
+      chunks(c)%field%x_max = right(c)-left(c)+1
+      chunks(c)%field%y_max = y_cells
+
+    ENDDO
+
+    DO c=1,number_of_chunks
+      IF(chunks(c)%task.EQ.parallel%task.AND.resized)THEN
+        CALL resize_opencl(chunks(c)%field%x_min, chunks(c)%field%x_max, &
+                           chunks(c)%field%y_min, chunks(c)%field%y_max, number_of_states, &
+                           g_small, g_big, dtmin, dtc_safe, dtu_safe, dtv_safe, dtdiv_safe, &
+                           chunks(c)%chunk_neighbours)
+      ELSEIF(chunks(c)%task.EQ.parallel%task)THEN
+        ! Append //char(0) to hack around C/Fortran interop
+        CALL setup_opencl(TRIM(OpenCL_vendor)//char(0), TRIM(OpenCL_type)//char(0),&
+                          chunks(c)%field%x_min, chunks(c)%field%x_max, &
+                          chunks(c)%field%y_min, chunks(c)%field%y_max, number_of_states, &
+                          g_small, g_big, dtmin, dtc_safe, dtu_safe, dtv_safe, dtdiv_safe, &
+                          ocl_autotune, ocl_single_reduction, ocl_batched_halo, &
+                          ocl_pipelined_exchange, ocl_pinned_staging, ocl_buffer_swap, &
+                          ocl_fused_advec, ocl_fused_mom, ocl_event_profile, &
+                          ocl_step_replay, ocl_interior_tiles, &
+                          chunks(c)%chunk_neighbours, number_of_members, ocl_native)
+      ENDIF
+    ENDDO
+
+    CALL clover_barrier
+
+    DO c=1,number_of_chunks
+      IF(chunks(c)%task.EQ.parallel%task)THEN
+        CALL clover_allocate_buffers(c)
+      ENDIF
+    ENDDO
+
+    DO c=1,number_of_chunks
+      IF(chunks(c)%task.EQ.parallel%task)THEN
+        CALL initialise_chunk(c)
+      ENDIF
+    ENDDO
+
+    IF(parallel%boss)THEN
+       WRITE(g_out,*) 'Generating chunks'
+    ENDIF
+
+    DO c=1,number_of_chunks
+      IF(chunks(c)%task.EQ.parallel%task)THEN
+        CALL generate_chunk(c)
+      ENDIF
+    ENDDO
+
+  END SUBROUTINE setup_chunks
+
+  SUBROUTINE calibrate_chunk_throughput(weights)
+
+    ! Times passes of the EOS and timestep kernels on each chunk, with no
+    ! communication in the loop, and gathers the cells per second of every
+    ! chunk. Each of several trials runs whole sets of passes for at least a
+    ! minimum time, and the median trial is taken so one disturbed trial does
+    ! not skew the decomposition
+
+    REAL(KIND=8) :: weights(:)
+
+    INTEGER, PARAMETER :: calibration_trials=5
+    REAL(KIND=8), PARAMETER :: calibration_min_time=0.1_8
+
+    INTEGER :: c,pass,passes,trial,t,jldt,kldt
+    REAL(KIND=8) :: timer,kernel_time,throughput
+    REAL(KIND=8) :: trial_throughput(calibration_trials),swap
+    REAL(KIND=8) :: dtlp,xl_pos,yl_pos
+    CHARACTER(LEN=8) :: dtl_control
+
+    throughput=0.0_8
+
+    DO c=1,number_of_chunks
+      IF(chunks(c)%task.EQ.parallel%task)THEN
+        ! The first pass carries the one off launch costs, so is not timed
+        CALL ideal_gas(c,.FALSE.)
+        CALL calc_dt_enqueue(c,.FALSE.)
+        CALL calc_dt_collect(c,1,dtlp,dtl_control,xl_pos,yl_pos,jldt,kldt)
+
+        DO trial=1,calibration_trials
+          passes=0
+          kernel_time=timer()
+          DO
+            DO pass=1,balance_calibration_steps
+              CALL ideal_gas(c,.FALSE.)
+              CALL calc_dt_enqueue(c,.FALSE.)
+              CALL calc_dt_collect(c,1,dtlp,dtl_control,xl_pos,yl_pos,jldt,kldt)
+            ENDDO
+            passes=passes+balance_calibration_steps
+            IF(timer()-kernel_time.GE.calibration_min_time) EXIT
+          ENDDO
+          kernel_time=timer()-kernel_time
+
+          trial_throughput(trial)=REAL(chunks(c)%field%x_max,8)*REAL(chunks(c)%field%y_max,8) &
+                                 *passes/MAX(kernel_time,g_small)
+        ENDDO
+
+        DO trial=2,calibration_trials
+          swap=trial_throughput(trial)
+          t=trial-1
+          DO WHILE(t.GE.1)
+            IF(trial_throughput(t).LE.swap) EXIT
+            trial_throughput(t+1)=trial_throughput(t)
+            t=t-1
+          ENDDO
+          trial_throughput(t+1)=swap
+        ENDDO
+        throughput=trial_throughput((calibration_trials+1)/2)
+      ENDIF
+    ENDDO
+
+    CALL clover_allgather(throughput,weights)
+
+  END SUBROUTINE calibrate_chunk_throughput
+
 END SUBROUTINE start
@@ -44,35 +44,60 @@ SUBROUTINE timestep()
 
   CHARACTER(LEN=8) :: dt_control,dtl_control
 
-  INTEGER :: small
-
   INTEGER :: fields(NUM_FIELDS)
 
-!$ INTEGER :: OMP_GET_THREAD_NUM
-
   dt    = g_big
-  small=0
+
+  IF(OpenCL_fused_timestep) THEN
+    ! Density, energy and velocity are not changed by the EOS so their halos
+    ! can be exchanged up front, letting the fused kernel recompute pressure
+    ! in the halo cells it needs for the viscosity
+    fields=0
+    fields(FIELD_ENERGY0)=1
+    fields(FIELD_DENSITY0)=1
+    fields(FIELD_XVEL0)=1
+    fields(FIELD_YVEL0)=1
+    CALL update_halo(fields,1)
+  ELSE
+    DO c = 1, number_of_chunks
+      CALL ideal_gas(c,.FALSE.)
+    END DO
+
+    fields=0
+    fields(FIELD_PRESSURE)=1
+    fields(FIELD_ENERGY0)=1
+    fields(FIELD_DENSITY0)=1
+    fields(FIELD_XVEL0)=1
+    fields(FIELD_YVEL0)=1
+    CALL update_halo(fields,1)
+
+    CALL viscosity()
+
+    fields=0
+    fields(FIELD_VISCOSITY)=1
+    CALL update_halo(fields,1)
+  ENDIF
 
   DO c = 1, number_of_chunks
-    CALL ideal_gas(c,.FALSE.)
+    CALL calc_dt_enqueue(c,OpenCL_fused_timestep)
   END DO
 
-  fields=0
-  fields(FIELD_PRESSURE)=1
-  fields(FIELD_ENERGY0)=1
-  fields(FIELD_DENSITY0)=1
-  fields(FIELD_XVEL0)=1
-  fields(FIELD_YVEL0)=1
-  CALL update_halo(fields,1)
-
-  CALL viscosity()
+  IF(OpenCL_fused_timestep) THEN
+    ! Accelerate and PdV still read the pressure and viscosity halos
+    fields=0
+    fields(FIELD_PRESSURE)=1
+    fields(FIELD_VISCOSITY)=1
+    CALL update_halo(fields,1)
+  ENDIF
 
-  fields=0
-  fields(FIELD_VISCOSITY)=1
-  CALL update_halo(fields,1)
+  IF(number_of_members.GT.1) THEN
+    CALL timestep_members()
+    RETURN
+  ENDIF
 
+  ! With opencl_async_dt this is the first point the host waits on the result
   DO c = 1, number_of_chunks
-    CALL calc_dt(c,dtlp,dtl_control,xl_pos,yl_pos,jldt,kldt)
+    CALL calc_dt_collect(c,1,dtlp,dtl_control,xl_pos,yl_pos,jldt,kldt)
 
     IF(dtlp.LE.dt) THEN
       dt=dtlp
@@ -88,7 +113,132 @@ SUBROUTINE timestep()
 
   CALL clover_min(dt)
 
-  IF(dt.LT.dtmin) small=1
+  CALL timestep_report(dt_control,x_pos,y_pos)
+
+END SUBROUTINE timestep
+
+SUBROUTINE timestep_members()
+
+  ! Each ensemble member takes its own dt, limited as timestep limits the
+  ! single dt, and the device is given all of them for the step. A member
+  ! that has reached end_time takes a zero step, which leaves it as it is
+
+  USE clover_module
+  USE report_module
+  USE calc_dt_module
+
+  IMPLICIT NONE
+
+  INTEGER :: member
+  INTEGER :: jldt,kldt
+
+  REAL(KIND=8)    :: dtlp
+  REAL(KIND=8)    :: xl_pos,yl_pos
+
+  CHARACTER(LEN=8) :: dtl_control
+
+  dt = g_big
+
+  ! An ensemble is a single chunk
+  DO member = 1, number_of_members
+    CALL calc_dt_collect(1,member,dtlp,dtl_control,xl_pos,yl_pos,jldt,kldt)
+
+    IF(.NOT.member_active(member)) THEN
+      member_dt(member)=0.0_8
+      CYCLE
+    ENDIF
+
+    member_dt(member) = MIN(dtlp, (member_dtold(member) * dtrise), dtmax)
+    member_dtold(member) = member_dt(member)
+    dt = MIN(dt, member_dt(member))
+
+    IF (parallel%boss) THEN
+      WRITE(g_out,"(' Step ', i7,' member ',i5,' time ', f11.7,' control ',a11,' timestep  ',1pe9.2,i8,',',i8, &
+                   &' x ',1pe9.2,' y ',1pe9.2)") &
+                      step,member,member_time(member),dtl_control,member_dt(member),jldt,kldt,xl_pos,yl_pos
+    ENDIF
+
+    IF(member_dt(member).LT.dtmin) THEN
+      CALL report_error('timestep','small timestep')
+    ENDIF
+  END DO
+
+  dtold = dt
+
+  CALL ensemble_dt_ocl(member_dt)
+
+END SUBROUTINE timestep_members
+
+SUBROUTINE timestep_members_advance()
+
+  ! Moves each ensemble member on by its own dt. The run time is that of the
+  ! member furthest behind, so the run ends once every member has finished
+
+  USE clover_module
+
+  IMPLICIT NONE
+
+  INTEGER :: member
+
+  member_time = member_time + member_dt
+
+  DO member = 1, number_of_members
+    IF(member_time(member)+g_small.GT.end_time) member_active(member)=.FALSE.
+  END DO
+
+  time = MINVAL(member_time)
+
+END SUBROUTINE timestep_members_advance
+
+SUBROUTINE timestep_replay(replayed)
+
+  ! Runs the whole step from the recording for this sweep order, if there is
+  ! one, and reports the dt it took as timestep does
+
+  USE clover_module
+
+  IMPLICIT NONE
+
+  LOGICAL :: replayed
+
+  INTEGER :: parity,ocl_replayed,l_control
+
+  REAL(KIND=8)    :: x_pos,y_pos
+
+  CHARACTER(LEN=8) :: dt_control
+
+  parity=0
+  IF(advect_x) parity=1
+
+  ! A dt below dtmin comes back without the fields advanced, for
+  ! timestep_report to stop the run on
+  CALL ocl_replay_step(parity,dtmin,dt,l_control,x_pos,y_pos,jdt,kdt,ocl_replayed)
+
+  replayed=(ocl_replayed.EQ.1)
+  IF(.NOT.replayed) RETURN
+
+  dt_control='unknown'
+  IF(l_control.EQ.1) dt_control='sound'
+  IF(l_control.EQ.2) dt_control='xvel'
+  IF(l_control.EQ.3) dt_control='yvel'
+  IF(l_control.EQ.4) dt_control='div'
+
+  CALL timestep_report(dt_control,x_pos,y_pos)
+
+END SUBROUTINE timestep_replay
+
+SUBROUTINE timestep_report(dt_control,x_pos,y_pos)
+
+  USE clover_module
+  USE report_module
+
+  IMPLICIT NONE
+
+  CHARACTER(LEN=8) :: dt_control
+
+  REAL(KIND=8)    :: x_pos,y_pos
+
+!$ INTEGER :: OMP_GET_THREAD_NUM
 
   IF (parallel%boss) THEN
 !$  IF(OMP_GET_THREAD_NUM().EQ.0) THEN
@@ -99,12 +249,12 @@ SUBROUTINE timestep()
 !$  ENDIF
   ENDIF
 
-  IF(small.EQ.1) THEN
+  IF(dt.LT.dtmin) THEN
     CALL report_error('timestep','small timestep')
   ENDIF
 
   dtold = dt
 
-END SUBROUTINE timestep
+END SUBROUTINE timestep_report
 
 END MODULE timestep_module
@@ -0,0 +1,181 @@
+/*Crown Copyright 2012 AWE.
+*
+* This file is part of CloverLeaf.
+*
+* CloverLeaf is free software: you can redistribute it and/or modify it under
+* the terms of the GNU General Public License as published by the
+* Free Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* CloverLeaf is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* CloverLeaf. If not, see http://www.gnu.org/licenses/. */
+
+/**
+ *  @brief OCL device-side fused timestep kernel
+ *  @author Andrew Mallinson, David Beckingsale, Wayne Gaudin
+ *  @details Combines the ideal gas, viscosity and timestep calculations in a
+ *  single pass. Each work group evaluates the equation of state for its tile
+ *  plus a one cell halo into local memory, so the viscosity stencil never
+ *  reads pressure from global memory, and then reduces the per cell timestep
+ *  to a single minimum per work group exactly as calc_dt_ocl_kernel does.
+ *  The density, energy and velocity halos must be up to date before launch.
+ *  The equation of state and viscosity compute in calc_t, as the unfused
+ *  kernels do, so a mixed build gives the same fields either way.
+ */
+
+#include "ocl_knls.h"
+
+#define TILE_X (CALCDT_WG_X+2)
+#define TILE_Y (CALCDT_WG_Y+2)
+
+#define PRESSURE_TILE(j,k) pressure_tile[(k)*TILE_X+(j)]
+
+__kernel __attribute__((reqd_work_group_size(CALCDT_WG_X, CALCDT_WG_Y, 1)))
+void timestep_fused_ocl_kernel(
+        const double g_small,
+        const double g_big,
+        const double dtc_safe,              
+        const double dtu_safe,              
+        const double dtv_safe,              
+        const double dtdiv_safe,            
+        __global const field_t * restrict xarea,
+        __global const field_t * restrict yarea,
+        __global const field_t * restrict celldx,
+        __global const field_t * restrict celldy,
+        __global const field_t * restrict volume,
+        __global const field_t * restrict density0,
+        __global const field_t * restrict energy0,
+        __global field_t * restrict pressure,
+        __global field_t * restrict viscosity,
+        __global field_t * restrict soundspeed,
+        __global const field_t * restrict xvel0,
+        __global const field_t * restrict yvel0,
+	    __global double * restrict dt_min_val_array,
+        __global double * restrict dt_min_loc_array)
+{
+    calc_t v,pressurebyenergy,pressurebyvolume,sound_speed,visc,density,press;
+    calc_t ugrad,vgrad,grad2,pgradx,pgrady,pgradx2,pgrady2,grad,ygrad,pgrad,xgrad,strain2,limiter,div;
+    int control;
+
+    __local calc_t pressure_tile[TILE_X*TILE_Y];
+    __local double dt_min_local[WORKGROUP_SIZE];
+    __local int dt_loc_local[WORKGROUP_SIZE];
+
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    int localid = get_local_id(1)*get_local_size(0)+get_local_id(0);
+
+    int lj = get_local_id(0)+1;
+    int lk = get_local_id(1)+1;
+
+    int j_origin = get_group_id(0)*CALCDT_WG_X-1;
+    int k_origin = get_group_id(1)*CALCDT_WG_Y-1;
+
+    // Equation of state over the tile and its halo. The halo values match what
+    // update_halo would give for pressure as the EOS is point-wise.
+    for (int index = localid; index < TILE_X*TILE_Y; index += CALCDT_WG_X*CALCDT_WG_Y) {
+
+        int jt = j_origin + index % TILE_X;
+        int kt = k_origin + index / TILE_X;
+
+        if ( (jt>=1) && (jt<=XMAXPLUSTWO) && (kt>=1) && (kt<=YMAXPLUSTWO) ) {
+            pressure_tile[index] = CALC(1.4-1.0)*density0[ARRAYXY(jt,kt,XMAXPLUSFOUR)]*energy0[ARRAYXY(jt,kt,XMAXPLUSFOUR)];
+        } else {
+            pressure_tile[index] = 0.0;
+        }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    dt_min_local[localid] = g_big;
+    dt_loc_local[localid] = 0;
+
+    if ( (j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE) ) {
+
+        // ideal gas
+        density = density0[ARRAYXY(j,k,XMAXPLUSFOUR)];
+
+        // the sound speed is taken from the stored pressure, as ideal_gas does
+        pressure[ARRAYXY(j,k,XMAXPLUSFOUR)]=PRESSURE_TILE(lj,lk);
+        press = pressure[ARRAYXY(j,k,XMAXPLUSFOUR)];
+
+        v = CALC(1.0)/density;
+
+        pressurebyenergy=CALC(1.4-1.0)*density;
+
+        pressurebyvolume=-density*press;
+
+        sound_speed=sqrt(v*v*(press*pressurebyenergy-pressurebyvolume));
+
+        soundspeed[ARRAYXY(j,k,XMAXPLUSFOUR)]=sound_speed;
+
+        // viscosity
+        ugrad = (xvel0[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)]
+                +xvel0[ARRAYXY(j+1,k+1,XMAXPLUSFIVE)])
+               -(xvel0[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)]
+                +xvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)]);
+
+        vgrad = (yvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)]
+                +yvel0[ARRAYXY(j+1,k+1,XMAXPLUSFIVE)])
+               -(yvel0[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)]
+                +yvel0[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)]);
+
+        div = (celldx[j]*(ugrad) 
+              +celldy[k]*(vgrad));
+
+        strain2=CALC(0.5)*(xvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)]
+                    +xvel0[ARRAYXY(j+1,k+1,XMAXPLUSFIVE)]
+                    -xvel0[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)]
+                    -xvel0[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)])/celldy[k]
+               +CALC(0.5)*(yvel0[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)]
+                    +yvel0[ARRAYXY(j+1,k+1,XMAXPLUSFIVE)]
+                    -yvel0[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)]
+                    -yvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)])/celldx[j];
+
+        pgradx=(PRESSURE_TILE(lj+1,lk)-PRESSURE_TILE(lj-1,lk))/(celldx[j]+celldx[j+1]);
+        pgrady=(PRESSURE_TILE(lj,lk+1)-PRESSURE_TILE(lj,lk-1))/(celldy[k]+celldy[k+1]);
+
+        pgradx2 = pgradx*pgradx;
+        pgrady2 = pgrady*pgrady;
+
+        limiter = ((CALC(0.5)*(ugrad)/celldx[j])
+                    *pgradx2+(CALC(0.5)*(vgrad)/celldy[k])*pgrady2+strain2*pgradx*pgrady)
+                /fmax(pgradx2+pgrady2,CALC(1.0e-16));
+
+        pgradx = copysign(fmax(CALC(1.0e-16),fabs(pgradx)),pgradx);
+        pgrady = copysign(fmax(CALC(1.0e-16),fabs(pgrady)),pgrady);
+        pgrad = sqrt(pgradx*pgradx+pgrady*pgrady);
+        xgrad = fabs(celldx[j]*pgrad/pgradx);
+        ygrad = fabs(celldy[k]*pgrad/pgrady);
+        grad  = fmin(xgrad,ygrad);
+        grad2 = grad*grad;
+
+        if(limiter > CALC(0.0) || div >= CALC(0.0)){
+            visc=CALC(0.0);
+        } else {
+            visc=CALC(2.0)*density*grad2*limiter*limiter;
+        }
+
+        viscosity[ARRAYXY(j,k,XMAXPLUSFOUR)]=visc;
+
+        // timestep, from the viscosity and sound speed of this pass
+        dt_min_local[localid] = calc_dt_cell(j, k, g_small, g_big, dtc_safe, dtu_safe, dtv_safe, dtdiv_safe,
+                                             sound_speed, visc, density, xarea, yarea, celldx, celldy, volume,
+                                             xvel0, yvel0, &control);
+
+        dt_loc_local[localid] = calc_dt_location(j, k, control);
+    }
+
+    calc_dt_workgroup_min(dt_min_local, dt_loc_local, localid);
+
+    if (localid==0) { 
+        dt_min_val_array[get_group_id(1)*get_num_groups(0) + get_group_id(0)] = dt_min_local[0]; 
+        dt_min_loc_array[get_group_id(1)*get_num_groups(0) + get_group_id(0)] = dt_loc_local[0]; 
+    }
+}
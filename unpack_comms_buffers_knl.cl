@@ -27,7 +27,7 @@ __kernel void left_comm_buffer_unpack(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global double * restrict field,
+    __global field_t * restrict field,
     __global const double * restrict rcv_buffer)
 {
     int k = get_global_id(1);
@@ -46,7 +46,7 @@ __kernel void right_comm_buffer_unpack(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global double * restrict field,
+    __global field_t * restrict field,
     __global const double * restrict rcv_buffer)
 {
     int k = get_global_id(1);
@@ -65,7 +65,7 @@ __kernel void top_comm_buffer_unpack(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global double * restrict field,
+    __global field_t * restrict field,
     __global const double * restrict rcv_buffer)
 {
     int k = get_global_id(1);
@@ -84,7 +84,7 @@ __kernel void bottom_comm_buffer_unpack(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global double * restrict field,
+    __global field_t * restrict field,
     __global const double * restrict rcv_buffer)
 {
     int k = get_global_id(1);
@@ -98,3 +98,106 @@ __kernel void bottom_comm_buffer_unpack(
         field[ ARRAYXY(j, YMIN-k, XMAXPLUSFOUR+x_inc) ] = rcv_buffer[index];        
     }
 }
+
+/*
+ * Unpack a message holding every field in the mask, laid out as by the
+ * *_comm_buffer_pack_all kernels. faces selects which of the two receive
+ * buffers has arrived, so each face can be unpacked as soon as it lands.
+ */
+__kernel void left_right_comm_buffer_unpack_all(
+    const int depth,
+    const int mask,
+    const int faces,
+    const int stride,
+    __global field_t * restrict density0,
+    __global field_t * restrict density1,
+    __global field_t * restrict energy0,
+    __global field_t * restrict energy1,
+    __global field_t * restrict pressure,
+    __global field_t * restrict viscosity,
+    __global field_t * restrict soundspeed,
+    __global field_t * restrict xvel0,
+    __global field_t * restrict xvel1,
+    __global field_t * restrict yvel0,
+    __global field_t * restrict yvel1,
+    __global field_t * restrict vol_flux_x,
+    __global field_t * restrict vol_flux_y,
+    __global field_t * restrict mass_flux_x,
+    __global field_t * restrict mass_flux_y,
+    __global const field_t * restrict left_rcv_buffer,
+    __global const field_t * restrict right_rcv_buffer)
+{
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    __global field_t * fields[NUM_FIELDS] = { density0, density1, energy0, energy1, pressure,
+                                             viscosity, soundspeed, xvel0, xvel1, yvel0, yvel1,
+                                             vol_flux_x, vol_flux_y, mass_flux_x, mass_flux_y };
+
+    for (int f = 1; f <= NUM_FIELDS; f++) {
+
+        int x_inc = FIELD_X_INC(f);
+        int y_inc = FIELD_Y_INC(f);
+
+        if ( HALO_FIELD_SET(mask, f) && (k>=2-depth) && (k<=YMAXPLUSONE+y_inc+depth) ) {
+
+            int index = HALO_FIELD_SLOT(mask, f)*stride + j + (k+depth-2)*depth;
+
+            if (faces & HALO_FACE_LEFT) {
+                fields[f-1][ ARRAYXY(XMIN-j, k, XMAXPLUSFOUR+x_inc) ] = left_rcv_buffer[index];
+            }
+            if (faces & HALO_FACE_RIGHT) {
+                fields[f-1][ ARRAYXY(XMAXPLUSTWO+x_inc+j, k, XMAXPLUSFOUR+x_inc) ] = right_rcv_buffer[index];
+            }
+        }
+    }
+}
+
+__kernel void top_bottom_comm_buffer_unpack_all(
+    const int depth,
+    const int mask,
+    const int faces,
+    const int stride,
+    __global field_t * restrict density0,
+    __global field_t * restrict density1,
+    __global field_t * restrict energy0,
+    __global field_t * restrict energy1,
+    __global field_t * restrict pressure,
+    __global field_t * restrict viscosity,
+    __global field_t * restrict soundspeed,
+    __global field_t * restrict xvel0,
+    __global field_t * restrict xvel1,
+    __global field_t * restrict yvel0,
+    __global field_t * restrict yvel1,
+    __global field_t * restrict vol_flux_x,
+    __global field_t * restrict vol_flux_y,
+    __global field_t * restrict mass_flux_x,
+    __global field_t * restrict mass_flux_y,
+    __global const field_t * restrict bottom_rcv_buffer,
+    __global const field_t * restrict top_rcv_buffer)
+{
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    __global field_t * fields[NUM_FIELDS] = { density0, density1, energy0, energy1, pressure,
+                                             viscosity, soundspeed, xvel0, xvel1, yvel0, yvel1,
+                                             vol_flux_x, vol_flux_y, mass_flux_x, mass_flux_y };
+
+    for (int f = 1; f <= NUM_FIELDS; f++) {
+
+        int x_inc = FIELD_X_INC(f);
+        int y_inc = FIELD_Y_INC(f);
+
+        if ( HALO_FIELD_SET(mask, f) && (j>=2-depth) && (j<=XMAXPLUSONE+x_inc+depth) ) {
+
+            int index = HALO_FIELD_SLOT(mask, f)*stride + j - (2-depth) + k*(XMAX+x_inc+(2*depth));
+
+            if (faces & HALO_FACE_BOTTOM) {
+                fields[f-1][ ARRAYXY(j, YMIN-k, XMAXPLUSFOUR+x_inc) ] = bottom_rcv_buffer[index];
+            }
+            if (faces & HALO_FACE_TOP) {
+                fields[f-1][ ARRAYXY(j, YMAXPLUSTWO+y_inc+k, XMAXPLUSFOUR+x_inc) ] = top_rcv_buffer[index];
+            }
+        }
+    }
+}
@@ -24,9 +24,11 @@
  *  reflective.
  */
 
+#include "ocl_knls.h"
+
 __kernel void update_halo_bottom_cell_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -40,7 +42,7 @@ __kernel void update_halo_bottom_cell_ocl_kernel(
 
 __kernel void update_halo_bottom_vel_ocl_kernel(
     const int depth,
-    __global double * restrict field,
+    __global field_t * restrict field,
     const int multiplier)
 {
     int k = get_global_id(1);
@@ -55,7 +57,7 @@ __kernel void update_halo_bottom_vel_ocl_kernel(
 
 __kernel void update_halo_bottom_flux_x_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -69,7 +71,7 @@ __kernel void update_halo_bottom_flux_x_ocl_kernel(
 
 __kernel void update_halo_bottom_flux_y_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -87,7 +89,7 @@ __kernel void update_halo_bottom_flux_y_ocl_kernel(
 
 __kernel void update_halo_top_cell_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -101,7 +103,7 @@ __kernel void update_halo_top_cell_ocl_kernel(
 
 __kernel void update_halo_top_vel_ocl_kernel(
     const int depth,
-    __global double * restrict field,
+    __global field_t * restrict field,
     const int multiplier)
 {
     int k = get_global_id(1);
@@ -116,7 +118,7 @@ __kernel void update_halo_top_vel_ocl_kernel(
 
 __kernel void update_halo_top_flux_x_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -130,7 +132,7 @@ __kernel void update_halo_top_flux_x_ocl_kernel(
 
 __kernel void update_halo_top_flux_y_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -148,7 +150,7 @@ __kernel void update_halo_top_flux_y_ocl_kernel(
 
 __kernel void update_halo_left_cell_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -162,7 +164,7 @@ __kernel void update_halo_left_cell_ocl_kernel(
 
 __kernel void update_halo_left_vel_ocl_kernel(
     const int depth,
-    __global double * restrict field,
+    __global field_t * restrict field,
     const int multiplier)
 {
     int k = get_global_id(1);
@@ -177,7 +179,7 @@ __kernel void update_halo_left_vel_ocl_kernel(
 
 __kernel void update_halo_left_flux_x_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -191,7 +193,7 @@ __kernel void update_halo_left_flux_x_ocl_kernel(
 
 __kernel void update_halo_left_flux_y_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -208,7 +210,7 @@ __kernel void update_halo_left_flux_y_ocl_kernel(
 
 __kernel void update_halo_right_cell_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -221,7 +223,7 @@ __kernel void update_halo_right_cell_ocl_kernel(
 
 __kernel void update_halo_right_vel_ocl_kernel(
     const int depth,
-    __global double * restrict field,
+    __global field_t * restrict field,
     const int multiplier)
 {
     int k = get_global_id(1);
@@ -235,7 +237,7 @@ __kernel void update_halo_right_vel_ocl_kernel(
 
 __kernel void update_halo_right_flux_x_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -248,7 +250,7 @@ __kernel void update_halo_right_flux_x_ocl_kernel(
 
 __kernel void update_halo_right_flux_y_ocl_kernel(
     const int depth,
-    __global double * restrict field)
+    __global field_t * restrict field)
 {
     int k = get_global_id(1);
     int j = get_global_id(0);
@@ -258,3 +260,175 @@ __kernel void update_halo_right_flux_y_ocl_kernel(
         field[ k*XMAXPLUSFOUR+XMAXPLUSTWO+j ] = field[ k*XMAXPLUSFOUR+XMAX-j ];
     }
 }
+
+
+
+/*
+ * Batched halo update. A single launch updates every field selected in the
+ * mask for both of the faces named in the faces argument. The fields are
+ * bound once as kernel arguments 3-17 in the same order as the Fortran field
+ * numbering, so only depth, mask and faces change between calls. Faces that
+ * are not in the program's EXTERNAL_FACES are compiled out.
+ */
+
+inline void halo_bottom_top_strip(
+    const int j,
+    const int k,
+    const int depth,
+    const int faces,
+    __global field_t * restrict field,
+    const int width,
+    const int j_max,
+    const int bottom_src,
+    const int top_dst,
+    const int top_src,
+    const double multiplier)
+{
+    if ( (j>=2-depth) && (j<=j_max+depth) ) {
+
+        // each ensemble member reflects at its own bottom and top faces
+        for (int member = 0; member < ENSEMBLE_MEMBERS; member++) {
+
+            __global field_t * restrict member_field = field + member*MEMBER_ROWS*width;
+
+            if (faces & EXTERNAL_FACES & HALO_FACE_BOTTOM) {
+                member_field[ (YMIN - k)*width + j ] = multiplier*member_field[ (bottom_src + k)*width + j ];
+            }
+            if (faces & EXTERNAL_FACES & HALO_FACE_TOP) {
+                member_field[ (top_dst + k)*width + j ] = multiplier*member_field[ (top_src - k)*width + j ];
+            }
+        }
+    }
+}
+
+inline void halo_left_right_strip(
+    const int j,
+    const int k,
+    const int depth,
+    const int faces,
+    __global field_t * restrict field,
+    const int width,
+    const int k_max,
+    const int left_src,
+    const int right_dst,
+    const int right_src,
+    const double multiplier)
+{
+    if ( (k>=2-depth) && (k<=k_max+depth) ) {
+
+        if (faces & EXTERNAL_FACES & HALO_FACE_LEFT) {
+            field[ k*width + 1 - j ] = multiplier*field[ k*width + left_src + j ];
+        }
+        if (faces & EXTERNAL_FACES & HALO_FACE_RIGHT) {
+            field[ k*width + right_dst + j ] = multiplier*field[ k*width + right_src - j ];
+        }
+    }
+}
+
+__kernel void update_halo_bottom_top_batched_ocl_kernel(
+    const int depth,
+    const int mask,
+    const int faces,
+    __global field_t * restrict density0,
+    __global field_t * restrict density1,
+    __global field_t * restrict energy0,
+    __global field_t * restrict energy1,
+    __global field_t * restrict pressure,
+    __global field_t * restrict viscosity,
+    __global field_t * restrict soundspeed,
+    __global field_t * restrict xvel0,
+    __global field_t * restrict xvel1,
+    __global field_t * restrict yvel0,
+    __global field_t * restrict yvel1,
+    __global field_t * restrict vol_flux_x,
+    __global field_t * restrict vol_flux_y,
+    __global field_t * restrict mass_flux_x,
+    __global field_t * restrict mass_flux_y)
+{
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    #define CELL_BT(f) halo_bottom_top_strip(j, k, depth, faces, f, XMAXPLUSFOUR, XMAXPLUSONE, \
+                                             YMINPLUSONE, MEMBER_YMAX+2, MEMBER_YMAX+1, 1.0)
+    #define VEL_BT(f, m) halo_bottom_top_strip(j, k, depth, faces, f, XMAXPLUSFIVE, XMAXPLUSTWO, \
+                                               YMINPLUSTWO, MEMBER_YMAX+3, MEMBER_YMAX+1, m)
+    #define FLUX_X_BT(f) halo_bottom_top_strip(j, k, depth, faces, f, XMAXPLUSFIVE, XMAXPLUSTWO, \
+                                               YMINPLUSTWO, MEMBER_YMAX+2, MEMBER_YMAX, 1.0)
+    #define FLUX_Y_BT(f) halo_bottom_top_strip(j, k, depth, faces, f, XMAXPLUSFOUR, XMAXPLUSONE, \
+                                               YMINPLUSTWO, MEMBER_YMAX+3, MEMBER_YMAX+1, -1.0)
+
+    if (HALO_FIELD_SET(mask, 1))  CELL_BT(density0);
+    if (HALO_FIELD_SET(mask, 2))  CELL_BT(density1);
+    if (HALO_FIELD_SET(mask, 3))  CELL_BT(energy0);
+    if (HALO_FIELD_SET(mask, 4))  CELL_BT(energy1);
+    if (HALO_FIELD_SET(mask, 5))  CELL_BT(pressure);
+    if (HALO_FIELD_SET(mask, 6))  CELL_BT(viscosity);
+    if (HALO_FIELD_SET(mask, 7))  CELL_BT(soundspeed);
+    if (HALO_FIELD_SET(mask, 8))  VEL_BT(xvel0, 1.0);
+    if (HALO_FIELD_SET(mask, 9))  VEL_BT(xvel1, 1.0);
+    if (HALO_FIELD_SET(mask, 10)) VEL_BT(yvel0, -1.0);
+    if (HALO_FIELD_SET(mask, 11)) VEL_BT(yvel1, -1.0);
+    if (HALO_FIELD_SET(mask, 12)) FLUX_X_BT(vol_flux_x);
+    if (HALO_FIELD_SET(mask, 13)) FLUX_Y_BT(vol_flux_y);
+    if (HALO_FIELD_SET(mask, 14)) FLUX_X_BT(mass_flux_x);
+    if (HALO_FIELD_SET(mask, 15)) FLUX_Y_BT(mass_flux_y);
+
+    #undef CELL_BT
+    #undef VEL_BT
+    #undef FLUX_X_BT
+    #undef FLUX_Y_BT
+}
+
+__kernel void update_halo_left_right_batched_ocl_kernel(
+    const int depth,
+    const int mask,
+    const int faces,
+    __global field_t * restrict density0,
+    __global field_t * restrict density1,
+    __global field_t * restrict energy0,
+    __global field_t * restrict energy1,
+    __global field_t * restrict pressure,
+    __global field_t * restrict viscosity,
+    __global field_t * restrict soundspeed,
+    __global field_t * restrict xvel0,
+    __global field_t * restrict xvel1,
+    __global field_t * restrict yvel0,
+    __global field_t * restrict yvel1,
+    __global field_t * restrict vol_flux_x,
+    __global field_t * restrict vol_flux_y,
+    __global field_t * restrict mass_flux_x,
+    __global field_t * restrict mass_flux_y)
+{
+    int k = get_global_id(1);
+    int j = get_global_id(0);
+
+    #define CELL_LR(f) halo_left_right_strip(j, k, depth, faces, f, XMAXPLUSFOUR, YMAXPLUSONE, \
+                                             2, XMAXPLUSTWO, XMAXPLUSONE, 1.0)
+    #define VEL_LR(f, m) halo_left_right_strip(j, k, depth, faces, f, XMAXPLUSFIVE, YMAXPLUSTWO, \
+                                               3, XMAXPLUSTHREE, XMAXPLUSONE, m)
+    #define FLUX_X_LR(f) halo_left_right_strip(j, k, depth, faces, f, XMAXPLUSFIVE, YMAXPLUSONE, \
+                                               3, XMAXPLUSTHREE, XMAXPLUSONE, -1.0)
+    #define FLUX_Y_LR(f) halo_left_right_strip(j, k, depth, faces, f, XMAXPLUSFOUR, YMAXPLUSTWO, \
+                                               3, XMAXPLUSTWO, XMAX, 1.0)
+
+    if (HALO_FIELD_SET(mask, 1))  CELL_LR(density0);
+    if (HALO_FIELD_SET(mask, 2))  CELL_LR(density1);
+    if (HALO_FIELD_SET(mask, 3))  CELL_LR(energy0);
+    if (HALO_FIELD_SET(mask, 4))  CELL_LR(energy1);
+    if (HALO_FIELD_SET(mask, 5))  CELL_LR(pressure);
+    if (HALO_FIELD_SET(mask, 6))  CELL_LR(viscosity);
+    if (HALO_FIELD_SET(mask, 7))  CELL_LR(soundspeed);
+    if (HALO_FIELD_SET(mask, 8))  VEL_LR(xvel0, -1.0);
+    if (HALO_FIELD_SET(mask, 9))  VEL_LR(xvel1, -1.0);
+    if (HALO_FIELD_SET(mask, 10)) VEL_LR(yvel0, 1.0);
+    if (HALO_FIELD_SET(mask, 11)) VEL_LR(yvel1, 1.0);
+    if (HALO_FIELD_SET(mask, 12)) FLUX_X_LR(vol_flux_x);
+    if (HALO_FIELD_SET(mask, 13)) FLUX_Y_LR(vol_flux_y);
+    if (HALO_FIELD_SET(mask, 14)) FLUX_X_LR(mass_flux_x);
+    if (HALO_FIELD_SET(mask, 15)) FLUX_Y_LR(mass_flux_y);
+
+    #undef CELL_LR
+    #undef VEL_LR
+    #undef FLUX_X_LR
+    #undef FLUX_Y_LR
+}
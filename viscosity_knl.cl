@@ -26,20 +26,20 @@
 #include "ocl_knls.h"
 
 __kernel void viscosity_ocl_kernel(
-        __global const double * restrict celldx,
-        __global const double * restrict celldy,
-        __global const double * restrict density0,
-        __global const double * restrict pressure,
-        __global double * restrict viscosity,
-        __global const double * restrict xvel0,
-        __global const double * restrict yvel0)
+        __global const field_t * restrict celldx,
+        __global const field_t * restrict celldy,
+        __global const field_t * restrict density0,
+        __global const field_t * restrict pressure,
+        __global field_t * restrict viscosity,
+        __global const field_t * restrict xvel0,
+        __global const field_t * restrict yvel0)
 {
-    double ugrad,vgrad,grad2,pgradx,pgrady,pgradx2,pgrady2,grad,ygrad,pgrad,xgrad,div,strain2,limiter;
+    calc_t ugrad,vgrad,grad2,pgradx,pgrady,pgradx2,pgrady2,grad,ygrad,pgrad,xgrad,div,strain2,limiter;
 
     int k = get_global_id(1);
     int j = get_global_id(0);
 
-    if ((j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE)) {
+    if (IN_RANGE((j>=2) && (j<=XMAXPLUSONE) && (k>=2) && (k<=YMAXPLUSONE))) {
 
           ugrad = (xvel0[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)]
                   +xvel0[ARRAYXY(j+1,k+1,XMAXPLUSFIVE)])
@@ -54,11 +54,11 @@ __kernel void viscosity_ocl_kernel(
           div = (celldx[j]*(ugrad) 
 	            +celldy[k]*(vgrad));
 
-          strain2=0.5*(xvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)]
+          strain2=CALC(0.5)*(xvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)]
                       +xvel0[ARRAYXY(j+1,k+1,XMAXPLUSFIVE)]
                       -xvel0[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)]
                       -xvel0[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)])/celldy[k]
-                 +0.5*(yvel0[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)]
+                 +CALC(0.5)*(yvel0[ARRAYXY(j+1,k  ,XMAXPLUSFIVE)]
                       +yvel0[ARRAYXY(j+1,k+1,XMAXPLUSFIVE)]
                       -yvel0[ARRAYXY(j  ,k  ,XMAXPLUSFIVE)]
                       -yvel0[ARRAYXY(j  ,k+1,XMAXPLUSFIVE)])/celldx[j];
@@ -73,22 +73,22 @@ __kernel void viscosity_ocl_kernel(
           pgradx2 = pgradx*pgradx;
           pgrady2 = pgrady*pgrady;
 
-          limiter = ((0.5*(ugrad)/celldx[j])
-                      *pgradx2+(0.5*(vgrad)/celldy[k])*pgrady2+strain2*pgradx*pgrady)
-                  /fmax(pgradx2+pgrady2,1.0e-16);
+          limiter = ((CALC(0.5)*(ugrad)/celldx[j])
+                      *pgradx2+(CALC(0.5)*(vgrad)/celldy[k])*pgrady2+strain2*pgradx*pgrady)
+                  /fmax(pgradx2+pgrady2,CALC(1.0e-16));
 
-          pgradx = copysign(fmax(1.0e-16,fabs(pgradx)),pgradx);
-          pgrady = copysign(fmax(1.0e-16,fabs(pgrady)),pgrady);
+          pgradx = copysign(fmax(CALC(1.0e-16),fabs(pgradx)),pgradx);
+          pgrady = copysign(fmax(CALC(1.0e-16),fabs(pgrady)),pgrady);
           pgrad = sqrt(pgradx*pgradx+pgrady*pgrady);
           xgrad = fabs(celldx[j]*pgrad/pgradx);
           ygrad = fabs(celldy[k]*pgrad/pgrady);
           grad  = fmin(xgrad,ygrad);
           grad2 = grad*grad;
 
-          if(limiter > 0.0 || div >= 0.0){
+          if(limiter > CALC(0.0) || div >= CALC(0.0)){
               viscosity[ARRAYXY(j,k,XMAXPLUSFOUR)]=0.0;
           } else {
-              viscosity[ARRAYXY(j,k,XMAXPLUSFOUR)]=2.0*density0[ARRAYXY(j,k,XMAXPLUSFOUR)]*grad2*limiter*limiter;
+              viscosity[ARRAYXY(j,k,XMAXPLUSFOUR)]=CALC(2.0)*density0[ARRAYXY(j,k,XMAXPLUSFOUR)]*grad2*limiter*limiter;
           }
     }
 }
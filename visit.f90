@@ -91,6 +91,16 @@ SUBROUTINE visit
   DO c = 1, number_of_chunks
     IF(chunks(c)%task.EQ.parallel%task) THEN
 
+      IF(use_OpenCL_kernels.AND.OpenCL_binary_vis) THEN
+        ! Snapshot the card and write binary VTK while the next steps run
+        CALL ocl_write_vis_binary(c,step                  &
+            ,chunks(c)%field%x_min                        &
+            ,chunks(c)%field%x_max                        &
+            ,chunks(c)%field%y_min                        &
+            ,chunks(c)%field%y_max)
+        CYCLE
+      ENDIF
+
       IF(use_OpenCL_kernels) THEN
         ! Bring data back from card ready for outputting
         CALL ocl_read_vis_buffers(chunks(c)%field%x_max   &
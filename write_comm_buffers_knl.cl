@@ -27,7 +27,7 @@ __kernel void write_top_buffer_ocl_kernel(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global double * restrict field,
+    __global field_t * restrict field,
     __global const double * restrict snd_buffer)
 {
     int k = get_global_id(1);
@@ -43,7 +43,7 @@ __kernel void write_bottom_buffer_ocl_kernel(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global double * restrict field,
+    __global field_t * restrict field,
     __global const double * restrict snd_buffer)
 {
     int k = get_global_id(1);
@@ -59,7 +59,7 @@ __kernel void write_left_buffer_ocl_kernel(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global double * restrict field,
+    __global field_t * restrict field,
     __global const double * restrict snd_buffer)
 {
     int j = get_global_id(1);
@@ -75,7 +75,7 @@ __kernel void write_right_buffer_ocl_kernel(
     const int depth,
     const int x_inc,
     const int y_inc,
-    __global double * restrict field,
+    __global field_t * restrict field,
     __global const double * restrict snd_buffer)
 {
     int j = get_global_id(1);